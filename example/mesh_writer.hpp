@@ -0,0 +1,259 @@
+//
+// Created by gomkyung2 on 10/18/26.
+//
+
+/*
+ * Streaming mesh writers, to be used as the handler of `off_parser::parse_stream`.
+ *
+ * Each writer consumes the elements as they are parsed and appends them to a large fixed-size buffer, which is written
+ * to the output stream only when it is full. Memory usage is therefore bounded by the buffer size, regardless of the
+ * mesh size.
+ *
+ * Usage:
+ *
+ * std::ifstream input { "input.off" };
+ * std::ofstream output { "output.ply", std::ios::binary };
+ * ply_writer<vertex<vec3<double>>, face<std::uint32_t>> writer { output };
+ * off_parser::parse_stream<vertex<vec3<double>>, face<std::uint32_t>>(input, writer);
+ * writer.finish();
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <charconv>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <ostream>
+#include <stdexcept>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+#include <off_parser/parser.hpp>
+
+class output_buffer{
+public:
+    explicit output_buffer(std::ostream &output, std::size_t capacity = std::size_t { 1 } << 22)
+        : output { output }, capacity { capacity } {
+        buffer.reserve(capacity);
+    }
+
+    void write(const char *data, std::size_t size){
+        if (buffer.size() + size > capacity){
+            flush();
+            if (size > capacity){
+                output.write(data, static_cast<std::streamsize>(size));
+                return;
+            }
+        }
+        buffer.insert(buffer.end(), data, data + size);
+    }
+
+    void write(std::string_view str){
+        write(str.data(), str.size());
+    }
+
+    // Write the object representation of value, in native byte order.
+    template <typename T>
+        requires std::is_trivially_copyable_v<T>
+    void write_binary(const T &value){
+        char bytes[sizeof(T)];
+        std::memcpy(bytes, &value, sizeof(T));
+        write(bytes, sizeof(T));
+    }
+
+    // Write the shortest decimal representation of value.
+    template <typename T>
+        requires std::is_arithmetic_v<T>
+    void write_text(T value){
+        char chars[32];
+        const auto [end, ec] = std::to_chars(std::begin(chars), std::end(chars), value);
+        write(chars, static_cast<std::size_t>(end - chars));
+    }
+
+    void flush(){
+        output.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+        buffer.clear();
+        if (!output){
+            throw std::runtime_error { "Failed to write the output." };
+        }
+    }
+
+private:
+    std::ostream &output;
+    std::size_t capacity;
+    std::vector<char> buffer;
+};
+
+namespace mesh_writer_details{
+    template <typename T>
+    concept has_color = requires(const T &element) { element.color; };
+
+    template <typename T>
+    concept has_optional_color = requires(const T &element) { element.color.has_value(); };
+
+    template <has_color T>
+    using color_type_of = typename T::color_type;
+
+    /**
+     * @brief Convert OFF color to 8-bit channels. OFF color channels are either integers in [0, 255] or floating points
+     * in [0, 1]; a color having any channel greater than 1 is regarded as the former.
+     */
+    template <off_parser::geometry::concepts::vec_type ColorT>
+    [[nodiscard]] std::array<std::uint8_t, ColorT::size> to_color_bytes(const ColorT &color) noexcept{
+        std::array<double, ColorT::size> channels;
+        OFF_PARSER_INDEX_SEQUENCE(Is, ColorT::size,
+            ((channels[Is] = static_cast<double>(off_parser::geometry::nth<Is>(color))), ...);
+        );
+
+        const double scale = std::ranges::any_of(channels, [](double channel) { return channel > 1.0; }) ? 1.0 : 255.0;
+
+        std::array<std::uint8_t, ColorT::size> result;
+        std::ranges::transform(channels, result.begin(), [=](double channel){
+            return static_cast<std::uint8_t>(std::clamp(std::round(channel * scale), 0.0, 255.0));
+        });
+        return result;
+    }
+
+    // Color of element as 8-bit channels. Missing optional color is opaque white.
+    template <has_color T>
+    [[nodiscard]] auto color_bytes_of(const T &element) noexcept{
+        if constexpr (has_optional_color<T>){
+            if (!element.color){
+                std::array<std::uint8_t, color_type_of<T>::size> white;
+                white.fill(255);
+                return white;
+            }
+            return to_color_bytes(*element.color);
+        }
+        else{
+            return to_color_bytes(element.color);
+        }
+    }
+
+    template <typename T>
+    void write_ply_color_properties(output_buffer &buffer){
+        constexpr std::array<std::string_view, 4> names { "red", "green", "blue", "alpha" };
+        for (std::size_t i = 0; i < color_type_of<T>::size; ++i){
+            buffer.write("property uchar ");
+            buffer.write(names[i]);
+            buffer.write("\n");
+        }
+    }
+}
+
+// Binary PLY writer, in the native byte order. Vertex and face colors are written as 8-bit channels if exist.
+template <off_parser::geometry::concepts::vertex_type VertexT, off_parser::geometry::concepts::face_type FaceT>
+class ply_writer{
+public:
+    explicit ply_writer(std::ostream &output) : buffer { output } { }
+
+    void on_header(const off_parser::off_header &header){
+        buffer.write("ply\n");
+        buffer.write(std::endian::native == std::endian::little
+            ? "format binary_little_endian 1.0\n"
+            : "format binary_big_endian 1.0\n");
+
+        buffer.write("element vertex ");
+        buffer.write_text(header.n_vertices);
+        buffer.write("\nproperty float x\nproperty float y\nproperty float z\n");
+        if constexpr (mesh_writer_details::has_color<VertexT>){
+            mesh_writer_details::write_ply_color_properties<VertexT>(buffer);
+        }
+
+        buffer.write("element face ");
+        buffer.write_text(header.n_faces);
+        buffer.write("\nproperty list uchar int vertex_indices\n");
+        if constexpr (mesh_writer_details::has_color<FaceT>){
+            mesh_writer_details::write_ply_color_properties<FaceT>(buffer);
+        }
+
+        buffer.write("end_header\n");
+    }
+
+    void on_vertex(const VertexT &vertex){
+        buffer.write_binary(static_cast<float>(vertex.position.x));
+        buffer.write_binary(static_cast<float>(vertex.position.y));
+        buffer.write_binary(static_cast<float>(vertex.position.z));
+        if constexpr (mesh_writer_details::has_color<VertexT>){
+            buffer.write_binary(mesh_writer_details::color_bytes_of(vertex));
+        }
+    }
+
+    void on_face(const FaceT &face){
+        if (face.vertex_indices.size() > std::numeric_limits<std::uint8_t>::max()){
+            throw std::runtime_error { "PLY face cannot have more than 255 vertices." };
+        }
+
+        buffer.write_binary(static_cast<std::uint8_t>(face.vertex_indices.size()));
+        for (auto index : face.vertex_indices){
+            buffer.write_binary(static_cast<std::int32_t>(index));
+        }
+        if constexpr (mesh_writer_details::has_color<FaceT>){
+            buffer.write_binary(mesh_writer_details::color_bytes_of(face));
+        }
+    }
+
+    // Must be called after parsing, to write the remaining buffer.
+    void finish(){
+        buffer.flush();
+    }
+
+private:
+    output_buffer buffer;
+};
+
+// Wavefront OBJ writer. Vertex colors are written as the "v x y z r g b" extension; face colors are not supported.
+template <off_parser::geometry::concepts::vertex_type VertexT, off_parser::geometry::concepts::face_type FaceT>
+class obj_writer{
+public:
+    explicit obj_writer(std::ostream &output) : buffer { output } { }
+
+    void on_header(const off_parser::off_header &header){
+        buffer.write("# ");
+        buffer.write_text(header.n_vertices);
+        buffer.write(" vertices, ");
+        buffer.write_text(header.n_faces);
+        buffer.write(" faces\n");
+    }
+
+    void on_vertex(const VertexT &vertex){
+        buffer.write("v ");
+        buffer.write_text(vertex.position.x);
+        buffer.write(" ");
+        buffer.write_text(vertex.position.y);
+        buffer.write(" ");
+        buffer.write_text(vertex.position.z);
+        if constexpr (mesh_writer_details::has_color<VertexT>){
+            // OBJ has no alpha channel.
+            const auto color = mesh_writer_details::color_bytes_of(vertex);
+            for (std::size_t i = 0; i < 3; ++i){
+                buffer.write(" ");
+                buffer.write_text(static_cast<float>(color[i]) / 255.f);
+            }
+        }
+        buffer.write("\n");
+    }
+
+    void on_face(const FaceT &face){
+        buffer.write("f");
+        for (auto index : face.vertex_indices){
+            buffer.write(" ");
+            buffer.write_text(static_cast<std::uint64_t>(index) + 1); // OBJ indices are 1-based.
+        }
+        buffer.write("\n");
+    }
+
+    // Must be called after parsing, to write the remaining buffer.
+    void finish(){
+        buffer.flush();
+    }
+
+private:
+    output_buffer buffer;
+};
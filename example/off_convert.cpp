@@ -0,0 +1,161 @@
+#include <fstream>
+#include <iostream>
+#include <algorithm>
+#include <filesystem>
+#include <cctype>
+
+#include <argparse/argparse.hpp>
+#include <off_parser/parser.hpp>
+#include <fmt/chrono.h>
+#include <fmt/std.h>
+#include <fmt/ostream.h>
+#include <fmt/color.h>
+
+#include "benchmark.hpp"
+#include "formatter.hpp"
+#include "mesh_writer.hpp"
+#include "type_mapper.hpp"
+
+using namespace off_parser;
+
+template <typename... Args>
+void println_warning(fmt::format_string<Args...> fmt, Args &&...args){
+    fmt::print(fg(fmt::terminal_color::yellow), "[WARNING] ");
+    fmt::print(fmt, std::forward<Args>(args)...);
+    fmt::print("\n");
+}
+
+/**
+ * @brief Check if the value is one of the valid values.
+ * @tparam T
+ * @param value
+ * @param valid_values
+ * @return \p true if \p value is one of the \p valid_values, \p false otherwise.
+ */
+template <std::equality_comparable T>
+constexpr bool is_one_of(T value, std::initializer_list<T> valid_values){
+    return std::ranges::find(valid_values, value) != valid_values.end();
+}
+
+template <template <typename, typename> typename WriterT>
+void convert(const std::filesystem::path &input_path, const std::filesystem::path &output_path, int n_vertex_color_channel, int n_face_color_channel){
+    using namespace off_parser::geometry;
+
+    // Vertex and face color are optional, since only some elements may be colored.
+    constexpr type_mapper vcmap {
+        make_type_mapping<vertex                 <vec3<double>              >>(0),
+        make_type_mapping<optional_colored_vertex<vec3<double>, vec3<double>>>(3),
+        make_type_mapping<optional_colored_vertex<vec3<double>, vec4<double>>>(4),
+    };
+    constexpr type_mapper fcmap {
+        make_type_mapping<face                 <std::uint32_t              >>(0),
+        make_type_mapping<optional_colored_face<std::uint32_t, vec3<double>>>(3),
+        make_type_mapping<optional_colored_face<std::uint32_t, vec4<double>>>(4),
+    };
+
+    // Large stream buffers amortize the I/O calls; they must be set before opening the files.
+    constexpr std::size_t stream_buffer_size = std::size_t { 1 } << 20;
+    std::vector<char> input_buffer(stream_buffer_size);
+    std::ifstream input;
+    input.rdbuf()->pubsetbuf(input_buffer.data(), static_cast<std::streamsize>(input_buffer.size()));
+    input.open(input_path);
+    if (!input){
+        throw std::runtime_error { fmt::format("Failed to open {}.", input_path) };
+    }
+
+    std::ofstream output { output_path, std::ios::binary };
+    if (!output){
+        throw std::runtime_error { fmt::format("Failed to open {}.", output_path) };
+    }
+
+    std::visit(
+        [&]<typename VertexProxy, typename FaceProxy>(VertexProxy, FaceProxy){
+            using vertex_type = typename VertexProxy::type;
+            using face_type = typename FaceProxy::type;
+
+            auto elapsed = benchmark([&]() {
+                WriterT<vertex_type, face_type> writer { output };
+                parse_stream<vertex_type, face_type>(input, writer);
+                if (input.fail()){
+                    throw std::runtime_error { fmt::format("Failed to parse {}; {} is incomplete.", input_path, output_path) };
+                }
+                writer.finish();
+            });
+            fmt::println("Converted {} -> {}. Elapsed: {}", input_path, output_path, elapsed);
+        },
+        vcmap.static_map(n_vertex_color_channel),
+        fcmap.static_map(n_face_color_channel)
+    );
+}
+
+int main(int argc, char **argv) {
+    argparse::ArgumentParser program { "OFF converter" };
+    program.add_argument("input")
+        .help("OFF file to convert");
+    program.add_argument("output")
+        .help("Output file");
+
+    program.add_argument("-f", "--format")
+        .help("Output format [ply, obj]. Deduced from the output file extension if not given.");
+
+    program.add_argument("-vcc", "--vertex-color-channels")
+        .default_value(0)
+        .scan<'i', int>()
+        .help("Number of vertex color channels. [0 -> no color, 3 -> RGB, 4 -> RGBA]");
+
+    program.add_argument("-fcc", "--face-color-channels")
+        .default_value(0)
+        .scan<'i', int>()
+        .help("Number of face color channels. [0 -> no color, 3 -> RGB, 4 -> RGBA]");
+
+    // Argument validation.
+    std::string format;
+    try{
+        program.parse_args(argc, argv);
+
+        if (!is_one_of(program.get<int>("-vcc"), { 0, 3, 4 })){
+            throw std::invalid_argument { "The number of vertex color channel must be 0 (no color), 3 (RGB) or 4 (RGBA)." };
+        }
+        if (!is_one_of(program.get<int>("-fcc"), { 0, 3, 4 })){
+            throw std::invalid_argument { "The number of face color channel must be 0 (no color), 3 (RGB) or 4 (RGBA)." };
+        }
+
+        format = program.present("-f").value_or(
+            std::filesystem::path { program.get<std::string>("output") }.extension().string());
+        std::ranges::transform(format, format.begin(), [](unsigned char c) { return std::tolower(c); });
+        if (format.starts_with('.')){
+            format.erase(0, 1);
+        }
+        if (!is_one_of<std::string_view>(format, { "ply", "obj" })){
+            throw std::invalid_argument { "The output format must be ply or obj." };
+        }
+    }
+    catch (const std::runtime_error &err){
+        fmt::println(std::cerr, "{}\n{}", err.what(), program);
+        return 1;
+    }
+    catch (const std::invalid_argument &err){
+        fmt::println(std::cerr, "{}", err.what());
+        return 2;
+    }
+
+    // Argument validation: not error, but warning.
+    if (format == "obj" && program.get<int>("-fcc") != 0){
+        println_warning("OBJ does not support face color. Face color will be ignored.");
+    }
+
+    try{
+        const std::filesystem::path input_path = program.get<std::string>("input");
+        const std::filesystem::path output_path = program.get<std::string>("output");
+        if (format == "ply"){
+            convert<ply_writer>(input_path, output_path, program.get<int>("-vcc"), program.get<int>("-fcc"));
+        }
+        else{
+            convert<obj_writer>(input_path, output_path, program.get<int>("-vcc"), 0);
+        }
+    }
+    catch (const std::runtime_error &err){
+        fmt::println(std::cerr, "{}", err.what());
+        return 3;
+    }
+}
@@ -0,0 +1,117 @@
+//
+// Created by gomkyung2 on 10/18/26.
+//
+
+// Reload benchmark: parse an OFF file repeatedly into the same mesh, and check that the reloads perform no allocation.
+
+#include <atomic>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <new>
+#include <vector>
+
+#include <argparse/argparse.hpp>
+#include <off_parser/parser.hpp>
+#include <fmt/chrono.h>
+#include <fmt/std.h>
+#include <fmt/ostream.h>
+#include <fmt/color.h>
+
+#include "benchmark.hpp"
+#include "formatter.hpp"
+
+using namespace off_parser;
+
+// Count every allocation of this program through the replaceable global operator new.
+namespace{
+    std::atomic<std::size_t> n_allocations = 0;
+}
+
+void *operator new(std::size_t size){
+    n_allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void *ptr = std::malloc(size == 0 ? 1 : size)){
+        return ptr;
+    }
+    throw std::bad_alloc{};
+}
+
+void operator delete(void *ptr) noexcept{
+    std::free(ptr);
+}
+
+void operator delete(void *ptr, std::size_t) noexcept{
+    std::free(ptr);
+}
+
+int main(int argc, char **argv){
+    argparse::ArgumentParser program { "OFF reload benchmark" };
+    program.add_argument("file")
+        .help("OFF file to reload");
+
+    program.add_argument("-n", "--reloads")
+        .default_value(10)
+        .scan<'i', int>()
+        .help("Number of reloads after the first load.");
+
+    try{
+        program.parse_args(argc, argv);
+    }
+    catch (const std::runtime_error &err){
+        fmt::println(std::cerr, "{}\n{}", err.what(), program);
+        return 1;
+    }
+
+    using namespace off_parser::geometry;
+    using mesh_t = mesh<optional_colored_vertex<vec3<float>, vec4<float>>, optional_colored_face<std::uint32_t, vec4<float>>>;
+
+    const std::filesystem::path path = program.get<std::string>("file");
+    const int n_reloads = program.get<int>("-n");
+
+    // A user-provided stream buffer survives close() and open(), so reopening the file does not allocate.
+    std::vector<char> input_buffer(std::size_t { 1 } << 20);
+    std::ifstream input;
+    input.rdbuf()->pubsetbuf(input_buffer.data(), static_cast<std::streamsize>(input_buffer.size()));
+
+    mesh_t mesh;
+    const auto load = [&](){
+        input.close();
+        input.clear();
+        input.open(path);
+        if (!input){
+            throw std::runtime_error { "Failed to open the file." };
+        }
+        parse_into(mesh, input);
+    };
+
+    try{
+        // The first load allocates the mesh storage, and the reloads reuse it.
+        std::size_t n_first_allocations = n_allocations.load(std::memory_order_relaxed);
+        const auto first_elapsed = benchmark(load);
+        n_first_allocations = n_allocations.load(std::memory_order_relaxed) - n_first_allocations;
+
+        std::size_t n_reload_allocations = 0;
+        std::chrono::duration<float, std::milli> reload_elapsed {};
+        for (int i = 0; i < n_reloads; ++i){
+            const std::size_t n_before = n_allocations.load(std::memory_order_relaxed);
+            reload_elapsed += benchmark(load);
+            n_reload_allocations += n_allocations.load(std::memory_order_relaxed) - n_before;
+        }
+
+        fmt::println("{}: {} vertices, {} faces", path, mesh.vertices.size(), mesh.faces.size());
+        fmt::println("First load: {} ({} allocations)", first_elapsed, n_first_allocations);
+        if (n_reloads > 0){
+            fmt::println("Reload: {} on average ({} allocations in {} reloads)", reload_elapsed / n_reloads, n_reload_allocations, n_reloads);
+        }
+
+        if (n_reload_allocations != 0){
+            fmt::print(fg(fmt::terminal_color::red), "[FAILED] ");
+            fmt::println("Reloading a mesh into its previous storage must not allocate.");
+            return 4;
+        }
+    }
+    catch (const std::runtime_error &err){
+        fmt::println(std::cerr, "{}", err.what());
+        return 3;
+    }
+}
@@ -0,0 +1,50 @@
+#include <cstdint>
+#include <string_view>
+
+#include <off_parser/static_parser.hpp>
+#include <fmt/core.h>
+
+// Contents of datasets/cgal/cube.off, parsed at compile time.
+constexpr std::string_view cube_off = R"(OFF
+8 12 0
+-1 -1 -1
+-1 1 -1
+1 1 -1
+1 -1 -1
+-1 -1 1
+-1 1 1
+1 1 1
+1 -1 1
+3  0 1 3
+3  3 1 2
+3  0 4 1
+3  1 4 5
+3  3 2 7
+3  7 2 6
+3  4 0 3
+3  7 4 3
+3  6 4 7
+3  6 5 4
+3  1 5 6
+3  2 1 6
+)";
+
+using namespace off_parser::geometry;
+
+constexpr static_mesh_extent cube_extent = off_parser::static_extent_of(cube_off);
+static_assert(cube_extent.n_vertices == 8 && cube_extent.n_faces == 12 && cube_extent.max_face_size == 3);
+
+constexpr auto cube = off_parser::parse_static<vertex<vec3<float>>, std::uint8_t, cube_extent>(cube_off);
+static_assert(cube.n_edges == 0);
+static_assert(cube.vertices[0].position.x == -1.f && cube.vertices[6].position.z == 1.f);
+static_assert(cube.faces[11].n_vertices == 3 &&
+              cube.faces[11].vertex_indices[0] == 2 && cube.faces[11].vertex_indices[1] == 1 && cube.faces[11].vertex_indices[2] == 6);
+
+// Numbers are correctly rounded, like std::from_chars.
+constexpr std::string_view point_off = "OFF\n1 0 0\n0.1 3.4028234e38 4.9e-324\n";
+constexpr auto point = off_parser::parse_static<vertex<vec3<double>>, std::uint8_t, off_parser::static_extent_of(point_off)>(point_off);
+static_assert(point.vertices[0].position.x == 0.1 && point.vertices[0].position.y == 3.4028234e38 && point.vertices[0].position.z == 4.9e-324);
+
+int main(){
+    fmt::println("Parsed cube.off at compile time: {} vertices, {} faces", cube.vertices.size(), cube.faces.size());
+}
@@ -0,0 +1,669 @@
+//
+// Created by gomkyung2 on 10/18/26.
+//
+
+// Bounding volume hierarchy over the faces of a parsed mesh, built top-down with binned SAH, for ray casting and
+// closest point queries. Faces with more than 3 vertices are treated as triangle fans, and smaller faces are ignored.
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+#include "parser.hpp"
+#include "details/parallel.hpp"
+#include "details/vec3_math.hpp"
+
+namespace off_parser{
+    template <std::floating_point T>
+    struct aabb{
+        geometry::vec3<T> min {  std::numeric_limits<T>::infinity(),  std::numeric_limits<T>::infinity(),  std::numeric_limits<T>::infinity() };
+        geometry::vec3<T> max { -std::numeric_limits<T>::infinity(), -std::numeric_limits<T>::infinity(), -std::numeric_limits<T>::infinity() };
+
+        [[nodiscard]] constexpr bool empty() const noexcept{
+            return min.x > max.x;
+        }
+
+        constexpr void grow(const geometry::vec3<T> &point) noexcept{
+            min = { std::min(min.x, point.x), std::min(min.y, point.y), std::min(min.z, point.z) };
+            max = { std::max(max.x, point.x), std::max(max.y, point.y), std::max(max.z, point.z) };
+        }
+
+        constexpr void grow(const aabb &other) noexcept{
+            min = { std::min(min.x, other.min.x), std::min(min.y, other.min.y), std::min(min.z, other.min.z) };
+            max = { std::max(max.x, other.max.x), std::max(max.y, other.max.y), std::max(max.z, other.max.z) };
+        }
+
+        [[nodiscard]] constexpr geometry::vec3<T> centroid() const noexcept{
+            return { (min.x + max.x) / 2, (min.y + max.y) / 2, (min.z + max.z) / 2 };
+        }
+
+        // Half of the surface area, which is enough for the SAH cost comparison.
+        [[nodiscard]] constexpr T half_area() const noexcept{
+            if (empty()){
+                return T { 0 };
+            }
+            const T dx = max.x - min.x, dy = max.y - min.y, dz = max.z - min.z;
+            return dx * dy + dy * dz + dz * dx;
+        }
+    };
+
+    template <std::floating_point T>
+    struct ray{
+        geometry::vec3<T> origin;
+        geometry::vec3<T> direction;
+        T t_min = T { 0 };
+        T t_max = std::numeric_limits<T>::infinity();
+    };
+
+    template <std::floating_point T>
+    struct ray_hit{
+        std::uint32_t face;
+        T t;    // Ray parameter of the hit point.
+        T u, v; // Barycentric coordinates in the hit triangle of the face fan.
+    };
+
+    template <std::floating_point T>
+    struct closest_point_result{
+        std::uint32_t face;
+        geometry::vec3<T> point;
+        T distance_squared;
+    };
+
+    struct bvh_build_options{
+        std::size_t n_bins = 16; // Clamped to [2, 64].
+        std::size_t max_leaf_size = 8;
+        std::size_t parallel_threshold = 4096; // Subtrees with more faces are built concurrently, while threads are available.
+    };
+
+    namespace details{
+        template <typename T>
+        [[nodiscard]] constexpr T axis(const geometry::vec3<T> &v, std::size_t i) noexcept{
+            return i == 0 ? v.x : (i == 1 ? v.y : v.z);
+        }
+
+        template <std::floating_point T, geometry::concepts::vertex_type VertexT>
+        [[nodiscard]] constexpr geometry::vec3<T> position_of(const VertexT &vertex) noexcept{
+            const auto &position = geometry::position_of(vertex);
+            return {
+                static_cast<T>(geometry::nth<0>(position)),
+                static_cast<T>(geometry::nth<1>(position)),
+                static_cast<T>(geometry::nth<2>(position))
+            };
+        }
+
+        template <std::floating_point T, geometry::concepts::face_type FaceT, typename VerticesT>
+        [[nodiscard]] aabb<T> face_bounds_of(const FaceT &face, const VerticesT &vertices){
+            aabb<T> bounds;
+            for (auto index : face.vertex_indices){
+                if (static_cast<std::size_t>(index) >= vertices.size()){
+                    throw std::out_of_range { "Face references a vertex index out of range." };
+                }
+                bounds.grow(position_of<T>(vertices[static_cast<std::size_t>(index)]));
+            }
+            return bounds;
+        }
+
+        // Möller-Trumbore ray-triangle intersection. Returns (t, u, v) if hit within [t_min, t_max].
+        template <typename T>
+        [[nodiscard]] std::optional<std::array<T, 3>> intersect_triangle(
+            const ray<T> &r, const geometry::vec3<T> &p0, const geometry::vec3<T> &p1, const geometry::vec3<T> &p2) noexcept
+        {
+            const auto e1 = p1 - p0, e2 = p2 - p0;
+            const auto p = cross(r.direction, e2);
+            const T det = dot(e1, p);
+            if (std::abs(det) <= std::numeric_limits<T>::epsilon() * dot(e1, e1)){
+                return std::nullopt; // Parallel or degenerate.
+            }
+
+            const T inv_det = T { 1 } / det;
+            const auto s = r.origin - p0;
+            const T u = dot(s, p) * inv_det;
+            if (u < T { 0 } || u > T { 1 }){
+                return std::nullopt;
+            }
+
+            const auto q = cross(s, e1);
+            const T v = dot(r.direction, q) * inv_det;
+            if (v < T { 0 } || u + v > T { 1 }){
+                return std::nullopt;
+            }
+
+            const T t = dot(e2, q) * inv_det;
+            if (t < r.t_min || t > r.t_max){
+                return std::nullopt;
+            }
+            return std::array { t, u, v };
+        }
+
+        // Closest point on triangle (Ericson, "Real-Time Collision Detection", 5.1.5).
+        template <typename T>
+        [[nodiscard]] geometry::vec3<T> closest_point_on_triangle(
+            const geometry::vec3<T> &p, const geometry::vec3<T> &a, const geometry::vec3<T> &b, const geometry::vec3<T> &c) noexcept
+        {
+            const auto ab = b - a, ac = c - a, ap = p - a;
+            const T d1 = dot(ab, ap), d2 = dot(ac, ap);
+            if (d1 <= 0 && d2 <= 0) return a;
+
+            const auto bp = p - b;
+            const T d3 = dot(ab, bp), d4 = dot(ac, bp);
+            if (d3 >= 0 && d4 <= d3) return b;
+
+            const T vc = d1 * d4 - d3 * d2;
+            if (vc <= 0 && d1 >= 0 && d3 <= 0) return a + ab * (d1 / (d1 - d3));
+
+            const auto cp = p - c;
+            const T d5 = dot(ab, cp), d6 = dot(ac, cp);
+            if (d6 >= 0 && d5 <= d6) return c;
+
+            const T vb = d5 * d2 - d1 * d6;
+            if (vb <= 0 && d2 >= 0 && d6 <= 0) return a + ac * (d2 / (d2 - d6));
+
+            const T va = d3 * d6 - d5 * d4;
+            if (va <= 0 && (d4 - d3) >= 0 && (d5 - d6) >= 0) return b + (c - b) * ((d4 - d3) / ((d4 - d3) + (d5 - d6)));
+
+            const T denom = T { 1 } / (va + vb + vc);
+            return a + ab * (vb * denom) + ac * (vc * denom);
+        }
+
+        template <typename T>
+        [[nodiscard]] T distance_squared_to_aabb(const geometry::vec3<T> &p, const aabb<T> &box) noexcept{
+            const T dx = std::max({ box.min.x - p.x, T { 0 }, p.x - box.max.x });
+            const T dy = std::max({ box.min.y - p.y, T { 0 }, p.y - box.max.y });
+            const T dz = std::max({ box.min.z - p.z, T { 0 }, p.z - box.max.z });
+            return dx * dx + dy * dy + dz * dz;
+        }
+
+        // Slab test. Returns the entry distance if the ray hits the box within [t_min, t_max].
+        template <typename T>
+        [[nodiscard]] std::optional<T> intersect_aabb(
+            const ray<T> &r, const geometry::vec3<T> &inv_direction, const aabb<T> &box) noexcept
+        {
+            T t_enter = r.t_min, t_exit = r.t_max;
+            for (std::size_t i = 0; i < 3; ++i){
+                T t0 = (axis(box.min, i) - axis(r.origin, i)) * axis(inv_direction, i);
+                T t1 = (axis(box.max, i) - axis(r.origin, i)) * axis(inv_direction, i);
+                if (t0 > t1){
+                    std::swap(t0, t1);
+                }
+                // max/min ordered so that NaN (0 * inf) does not shrink the interval.
+                t_enter = t0 > t_enter ? t0 : t_enter;
+                t_exit = t1 < t_exit ? t1 : t_exit;
+            }
+            if (t_enter > t_exit){
+                return std::nullopt;
+            }
+            return t_enter;
+        }
+    }
+
+    // Parsed mesh, with the bounding box of each face computed while parsing.
+    template <geometry::concepts::mesh_type MeshT, std::floating_point T>
+    struct mesh_with_face_bounds{
+        MeshT mesh;
+        std::vector<aabb<T>> face_bounds;
+    };
+
+    /**
+     * @brief Parse \p input like parse, and compute the bounding box of each face as it is parsed, so that bvh::build
+     * does not need another pass over the faces.
+     */
+    template <geometry::concepts::mesh_type MeshT, std::floating_point T = double>
+    [[nodiscard]] mesh_with_face_bounds<MeshT, T> parse_with_face_bounds(std::istream &&input){
+        struct handler{
+            mesh_with_face_bounds<MeshT, T> result;
+
+            void on_header(const off_header &header){
+                result.mesh.n_edges = header.n_edges;
+                result.mesh.vertices.reserve(header.n_vertices);
+                result.mesh.faces.reserve(header.n_faces);
+                result.face_bounds.reserve(header.n_faces);
+            }
+
+            void on_vertex(const typename MeshT::vertex_type &vertex){
+                result.mesh.vertices.push_back(vertex);
+            }
+
+            void on_face(const typename MeshT::face_type &face){
+                result.face_bounds.push_back(details::face_bounds_of<T>(face, result.mesh.vertices));
+                result.mesh.faces.push_back(face);
+            }
+        } h;
+
+        parse_stream<typename MeshT::vertex_type, typename MeshT::face_type>(input, h);
+        return std::move(h.result);
+    }
+
+    template <std::floating_point T>
+    class bvh{
+    public:
+        using value_type = T;
+
+        struct node{
+            aabb<T> bounds;
+            std::uint32_t first; // Index of the left child (right child is first + 1) if count == 0, otherwise index of the first face in face_indices().
+            std::uint32_t count; // Number of faces if leaf, 0 if interior.
+
+            [[nodiscard]] constexpr bool is_leaf() const noexcept{
+                return count != 0;
+            }
+        };
+
+        /**
+         * @brief Build a BVH over the faces of \p mesh.
+         */
+        template <geometry::concepts::mesh_type MeshT>
+        [[nodiscard]] static bvh build(const MeshT &mesh, const bvh_build_options &options = {}){
+            std::vector<aabb<T>> face_bounds(mesh.faces.size());
+            details::parallel_for(mesh.faces.size(), 4096, [&](std::size_t i){
+                face_bounds[i] = details::face_bounds_of<T>(mesh.faces[i], mesh.vertices);
+            });
+            return build(mesh, face_bounds, options);
+        }
+
+        /**
+         * @brief Build a BVH over the faces of \p mesh, from the precomputed \p face_bounds (e.g. from
+         * parse_with_face_bounds).
+         */
+        template <geometry::concepts::mesh_type MeshT>
+        [[nodiscard]] static bvh build(const MeshT &mesh, std::span<const aabb<T>> face_bounds, const bvh_build_options &options = {}){
+            if (face_bounds.size() != mesh.faces.size()){
+                throw std::invalid_argument { "The number of face bounds does not match the number of faces." };
+            }
+            if (mesh.faces.size() >= std::numeric_limits<std::uint32_t>::max()){
+                throw std::length_error { "Too many faces for BVH." };
+            }
+
+            bvh result;
+            for (std::size_t i = 0; i < mesh.faces.size(); ++i){
+                if (mesh.faces[i].vertex_indices.size() >= 3){
+                    result.sorted_face_indices.push_back(static_cast<std::uint32_t>(i));
+                }
+            }
+            if (result.sorted_face_indices.empty()){
+                return result;
+            }
+
+            // Faces are partitioned by value rather than by index, so that binning reads contiguous memory.
+            std::vector<typename builder::primitive> primitives(result.sorted_face_indices.size());
+            details::parallel_for(primitives.size(), 4096, [&](std::size_t i){
+                const std::uint32_t face = result.sorted_face_indices[i];
+                primitives[i] = { face_bounds[face], face_bounds[face].centroid(), face };
+            });
+
+            builder b { options, primitives };
+            result.flat_nodes.resize(2 * primitives.size() - 1);
+            b.nodes = result.flat_nodes.data();
+            b.n_nodes = 1;
+            b.build();
+
+            for (std::size_t i = 0; i < primitives.size(); ++i){
+                result.sorted_face_indices[i] = primitives[i].face;
+            }
+            result.flat_nodes.resize(b.n_nodes.load());
+            result.flat_nodes.shrink_to_fit();
+            return result;
+        }
+
+        [[nodiscard]] std::span<const node> nodes() const noexcept{
+            return flat_nodes;
+        }
+
+        [[nodiscard]] std::span<const std::uint32_t> face_indices() const noexcept{
+            return sorted_face_indices;
+        }
+
+        /**
+         * @brief Find the nearest intersection of \p r with the faces of \p mesh, which must be the mesh this BVH was
+         * built from.
+         */
+        template <geometry::concepts::mesh_type MeshT>
+        [[nodiscard]] std::optional<ray_hit<T>> intersect(const MeshT &mesh, ray<T> r) const{
+            if (flat_nodes.empty()){
+                return std::nullopt;
+            }
+
+            const geometry::vec3<T> inv_direction { T { 1 } / r.direction.x, T { 1 } / r.direction.y, T { 1 } / r.direction.z };
+            if (!details::intersect_aabb(r, inv_direction, flat_nodes[0].bounds)){
+                return std::nullopt;
+            }
+
+            std::optional<ray_hit<T>> result;
+            std::array<std::uint32_t, max_depth> stack;
+            std::size_t stack_size = 0;
+            std::uint32_t current = 0;
+            while (true){
+                const node &n = flat_nodes[current];
+                if (n.is_leaf()){
+                    for (std::uint32_t i = n.first; i < n.first + n.count; ++i){
+                        const auto &face = mesh.faces[sorted_face_indices[i]];
+                        const auto p0 = details::position_of<T>(mesh.vertices[static_cast<std::size_t>(face.vertex_indices[0])]);
+                        for (std::size_t j = 2; j < face.vertex_indices.size(); ++j){
+                            const auto p1 = details::position_of<T>(mesh.vertices[static_cast<std::size_t>(face.vertex_indices[j - 1])]);
+                            const auto p2 = details::position_of<T>(mesh.vertices[static_cast<std::size_t>(face.vertex_indices[j])]);
+                            if (auto hit = details::intersect_triangle(r, p0, p1, p2)){
+                                r.t_max = (*hit)[0];
+                                result = ray_hit<T> { sorted_face_indices[i], (*hit)[0], (*hit)[1], (*hit)[2] };
+                            }
+                        }
+                    }
+                }
+                else{
+                    // Visit the nearer child first, and push the farther one.
+                    auto t_left = details::intersect_aabb(r, inv_direction, flat_nodes[n.first].bounds);
+                    auto t_right = details::intersect_aabb(r, inv_direction, flat_nodes[n.first + 1].bounds);
+                    if (t_left && t_right){
+                        const bool left_first = *t_left <= *t_right;
+                        stack[stack_size++] = left_first ? n.first + 1 : n.first;
+                        current = left_first ? n.first : n.first + 1;
+                        continue;
+                    }
+                    if (t_left || t_right){
+                        current = t_left ? n.first : n.first + 1;
+                        continue;
+                    }
+                }
+
+                if (stack_size == 0){
+                    break;
+                }
+                current = stack[--stack_size];
+            }
+            return result;
+        }
+
+        /**
+         * @brief Intersect every ray of \p rays concurrently. \p hits[i] is the result of \p rays[i].
+         */
+        template <geometry::concepts::mesh_type MeshT>
+        void intersect(const MeshT &mesh, std::span<const ray<T>> rays, std::span<std::optional<ray_hit<T>>> hits) const{
+            if (rays.size() != hits.size()){
+                throw std::invalid_argument { "The number of rays and hits must be the same." };
+            }
+            details::parallel_for(rays.size(), 256, [&](std::size_t i){
+                hits[i] = intersect(mesh, rays[i]);
+            });
+        }
+
+        /**
+         * @brief Find the closest point to \p point on the faces of \p mesh, which must be the mesh this BVH was built
+         * from.
+         * @param max_distance Points farther than this are not considered.
+         */
+        template <geometry::concepts::mesh_type MeshT>
+        [[nodiscard]] std::optional<closest_point_result<T>> closest_point(
+            const MeshT &mesh, const geometry::vec3<T> &point, T max_distance = std::numeric_limits<T>::infinity()) const
+        {
+            if (flat_nodes.empty()){
+                return std::nullopt;
+            }
+
+            std::optional<closest_point_result<T>> result;
+            T best = max_distance * max_distance;
+
+            // Each level pushes at most two children, and one of them is popped right away.
+            std::array<std::uint32_t, max_depth + 1> stack;
+            std::size_t stack_size = 0;
+            stack[stack_size++] = 0;
+            while (stack_size != 0){
+                const node &n = flat_nodes[stack[--stack_size]];
+                if (details::distance_squared_to_aabb(point, n.bounds) > best){
+                    continue;
+                }
+
+                if (n.is_leaf()){
+                    for (std::uint32_t i = n.first; i < n.first + n.count; ++i){
+                        const auto &face = mesh.faces[sorted_face_indices[i]];
+                        const auto p0 = details::position_of<T>(mesh.vertices[static_cast<std::size_t>(face.vertex_indices[0])]);
+                        for (std::size_t j = 2; j < face.vertex_indices.size(); ++j){
+                            const auto p1 = details::position_of<T>(mesh.vertices[static_cast<std::size_t>(face.vertex_indices[j - 1])]);
+                            const auto p2 = details::position_of<T>(mesh.vertices[static_cast<std::size_t>(face.vertex_indices[j])]);
+                            const auto candidate = details::closest_point_on_triangle(point, p0, p1, p2);
+                            if (const T distance_squared = details::distance_squared(candidate, point); distance_squared <= best){
+                                best = distance_squared;
+                                result = closest_point_result<T> { sorted_face_indices[i], candidate, distance_squared };
+                            }
+                        }
+                    }
+                    continue;
+                }
+
+                // Push the farther child first, so that the nearer one is visited first.
+                const T d_left = details::distance_squared_to_aabb(point, flat_nodes[n.first].bounds);
+                const T d_right = details::distance_squared_to_aabb(point, flat_nodes[n.first + 1].bounds);
+                if (d_left <= d_right){
+                    stack[stack_size++] = n.first + 1;
+                    stack[stack_size++] = n.first;
+                }
+                else{
+                    stack[stack_size++] = n.first;
+                    stack[stack_size++] = n.first + 1;
+                }
+            }
+            return result;
+        }
+
+        /**
+         * @brief Query the closest point of every point of \p points concurrently. \p results[i] is the result of
+         * \p points[i].
+         */
+        template <geometry::concepts::mesh_type MeshT>
+        void closest_point(const MeshT &mesh, std::span<const geometry::vec3<T>> points,
+                           std::span<std::optional<closest_point_result<T>>> results,
+                           T max_distance = std::numeric_limits<T>::infinity()) const
+        {
+            if (points.size() != results.size()){
+                throw std::invalid_argument { "The number of points and results must be the same." };
+            }
+            details::parallel_for(points.size(), 256, [&](std::size_t i){
+                results[i] = closest_point(mesh, points[i], max_distance);
+            });
+        }
+
+    private:
+        // Maximum depth of the tree, which bounds the traversal stack size.
+        static constexpr std::size_t max_depth = 64;
+
+        std::vector<node> flat_nodes;
+        std::vector<std::uint32_t> sorted_face_indices;
+
+        struct builder{
+            struct primitive{
+                aabb<T> bounds;
+                geometry::vec3<T> centroid;
+                std::uint32_t face;
+            };
+
+            const bvh_build_options &options;
+            std::span<primitive> primitives;
+            node *nodes = nullptr;
+            std::atomic<std::uint32_t> n_nodes = 0;
+
+            // Nodes with less faces than this are binned in a single thread.
+            static constexpr std::size_t parallel_grain = 1 << 16;
+            static constexpr std::size_t max_bins = 64;
+
+            std::size_t n_bins = std::clamp<std::size_t>(options.n_bins, 2, max_bins);
+
+            struct bin{
+                aabb<T> bounds;
+                aabb<T> centroid_bounds;
+                std::size_t count = 0;
+
+                void grow(const bin &other) noexcept{
+                    bounds.grow(other.bounds);
+                    centroid_bounds.grow(other.centroid_bounds);
+                    count += other.count;
+                }
+            };
+
+            // Bounds of the faces and of their centroids in primitives[begin, end).
+            [[nodiscard]] bin compute_bounds(std::size_t begin, std::size_t end) const{
+                std::vector<bin> partial(details::chunk_count(end - begin, parallel_grain));
+                const std::size_t n_chunks = details::parallel_for_chunks(end - begin, parallel_grain, [&](std::size_t chunk, std::size_t first, std::size_t last){
+                    for (std::size_t i = begin + first; i < begin + last; ++i){
+                        partial[chunk].bounds.grow(primitives[i].bounds);
+                        partial[chunk].centroid_bounds.grow(primitives[i].centroid);
+                    }
+                    partial[chunk].count = last - first;
+                });
+
+                for (std::size_t chunk = 1; chunk < n_chunks; ++chunk){
+                    partial[0].grow(partial[chunk]);
+                }
+                return partial[0];
+            }
+
+            [[nodiscard]] static std::size_t bin_index(const geometry::vec3<T> &centroid, std::size_t axis, T min, T scale, std::size_t n_bins) noexcept{
+                const auto index = static_cast<std::size_t>((details::axis(centroid, axis) - min) * scale);
+                return std::min(index, n_bins - 1);
+            }
+
+            void build(){
+                build_node(0, 0, primitives.size(), 0, compute_bounds(0, primitives.size()));
+            }
+
+            /**
+             * @brief Build the subtree of faces in primitives[begin, end).
+             * @param bounds Bounds of the faces and their centroids, which the parent already knows from its bins.
+             */
+            void build_node(std::uint32_t node_index, std::size_t begin, std::size_t end, std::size_t depth, const bin &bounds){
+                node &n = nodes[node_index];
+                n.bounds = bounds.bounds;
+
+                const std::size_t count = end - begin;
+                const auto make_leaf = [&]{
+                    n.first = static_cast<std::uint32_t>(begin);
+                    n.count = static_cast<std::uint32_t>(count);
+                };
+                if (count <= 1 || depth + 1 >= max_depth){
+                    make_leaf();
+                    return;
+                }
+
+                // Small nodes do not need more bins than faces.
+                const std::size_t n_bins = std::min(this->n_bins, count);
+
+                std::array<T, 3> mins, scales;
+                for (std::size_t axis = 0; axis < 3; ++axis){
+                    mins[axis] = details::axis(bounds.centroid_bounds.min, axis);
+                    const T extent = details::axis(bounds.centroid_bounds.max, axis) - mins[axis];
+                    scales[axis] = extent > T { 0 } ? static_cast<T>(n_bins) / extent : T { 0 };
+                }
+
+                // Bin the centroids along every axis in a single pass (concurrently for large nodes).
+                // partial_bins[(chunk * 3 + axis) * n_bins + i] is the i-th bin along axis, of the chunk.
+                std::vector<bin> partial_bins(details::chunk_count(count, parallel_grain) * 3 * n_bins);
+                const auto bins_of = [&](std::size_t chunk, std::size_t axis){
+                    return std::span { partial_bins }.subspan((chunk * 3 + axis) * n_bins, n_bins);
+                };
+                const std::size_t n_chunks = details::parallel_for_chunks(count, parallel_grain, [&](std::size_t chunk, std::size_t first, std::size_t last){
+                    for (std::size_t i = begin + first; i < begin + last; ++i){
+                        const auto &centroid = primitives[i].centroid;
+                        for (std::size_t axis = 0; axis < 3; ++axis){
+                            if (scales[axis] == T { 0 }){
+                                continue;
+                            }
+
+                            bin &b = bins_of(chunk, axis)[bin_index(centroid, axis, mins[axis], scales[axis], n_bins)];
+                            b.bounds.grow(primitives[i].bounds);
+                            ++b.count;
+                        }
+                    }
+                });
+                for (std::size_t chunk = 1; chunk < n_chunks; ++chunk){
+                    for (std::size_t axis = 0; axis < 3; ++axis){
+                        for (std::size_t i = 0; i < n_bins; ++i){
+                            bins_of(0, axis)[i].grow(bins_of(chunk, axis)[i]);
+                        }
+                    }
+                }
+
+                // Cost of a split is (traversal cost = 1) + sum of (child area / parent area) * (child face count).
+                T best_cost = std::numeric_limits<T>::infinity();
+                std::size_t best_axis = 0, best_split = 0;
+                for (std::size_t axis = 0; axis < 3; ++axis){
+                    if (scales[axis] == T { 0 }){
+                        continue;
+                    }
+
+                    const auto bins = bins_of(0, axis);
+                    std::array<T, max_bins> right_cost;
+                    aabb<T> right_bounds;
+                    std::size_t right_count = 0;
+                    for (std::size_t i = n_bins - 1; i > 0; --i){
+                        right_bounds.grow(bins[i].bounds);
+                        right_count += bins[i].count;
+                        right_cost[i] = right_bounds.half_area() * static_cast<T>(right_count);
+                    }
+
+                    aabb<T> left_bounds;
+                    std::size_t left_count = 0;
+                    for (std::size_t split = 1; split < n_bins; ++split){
+                        left_bounds.grow(bins[split - 1].bounds);
+                        left_count += bins[split - 1].count;
+                        const T cost = left_bounds.half_area() * static_cast<T>(left_count) + right_cost[split];
+                        if (cost < best_cost){
+                            best_cost = cost;
+                            best_axis = axis;
+                            best_split = split;
+                        }
+                    }
+                }
+
+                // All centroids coincide, or splitting a small node does not pay off.
+                const T leaf_cost = static_cast<T>(count);
+                const T split_cost = T { 1 } + best_cost / std::max(bounds.bounds.half_area(), std::numeric_limits<T>::min());
+                if (best_split == 0 || (count <= options.max_leaf_size && leaf_cost <= split_cost)){
+                    make_leaf();
+                    return;
+                }
+
+                // Bins only track the face bounds; the centroid bounds of the children are gathered while partitioning.
+                bin left_bounds, right_bounds;
+                for (std::size_t i = 0; i < n_bins; ++i){
+                    (i < best_split ? left_bounds : right_bounds).grow(bins_of(0, best_axis)[i]);
+                }
+
+                const auto goes_left = [&](const primitive &p){
+                    return bin_index(p.centroid, best_axis, mins[best_axis], scales[best_axis], n_bins) < best_split;
+                };
+                std::size_t split = begin, right_begin = end;
+                while (true){
+                    for (; split < right_begin && goes_left(primitives[split]); ++split){
+                        left_bounds.centroid_bounds.grow(primitives[split].centroid);
+                    }
+                    for (; split < right_begin && !goes_left(primitives[right_begin - 1]); --right_begin){
+                        right_bounds.centroid_bounds.grow(primitives[right_begin - 1].centroid);
+                    }
+                    if (split == right_begin){
+                        break;
+                    }
+                    std::swap(primitives[split], primitives[right_begin - 1]);
+                }
+
+                const std::uint32_t left = n_nodes.fetch_add(2);
+                n.first = left;
+                n.count = 0;
+
+                if (count > options.parallel_threshold){
+                    details::parallel_invoke(
+                        [&]{ build_node(left, begin, split, depth + 1, left_bounds); },
+                        [&]{ build_node(left + 1, split, end, depth + 1, right_bounds); });
+                }
+                else{
+                    build_node(left, begin, split, depth + 1, left_bounds);
+                    build_node(left + 1, split, end, depth + 1, right_bounds);
+                }
+            }
+        };
+    };
+}
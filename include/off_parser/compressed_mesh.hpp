@@ -0,0 +1,530 @@
+//
+// Created by gomkyung2 on 10/18/26.
+//
+
+// Compact in-memory encoding of a parsed mesh: quantized positions, delta-coded group varint indices and palette
+// colors. Faces are split into blocks that decode in parallel.
+//
+// const auto compressed = off_parser::compressed_mesh<mesh_t>::encode(mesh);
+// fmt::println("{} -> {} bytes", off_parser::memory_footprint(mesh), compressed.byte_size());
+// mesh_t restored = compressed.decode();
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "geometry/mesh.hpp"
+#include "concepts.hpp"
+#include "memory_footprint.hpp"
+#include "details/parallel.hpp"
+
+namespace off_parser{
+    struct compression_options{
+        unsigned position_bits = 16; // Quantization bits per axis, in [1, 16].
+        std::size_t faces_per_block = 4096; // Faces in an independently decodable index block.
+    };
+
+    namespace details{
+        // Group varint stream: each control byte holds the byte lengths (minus one) of four values, two bits each.
+        class group_varint_writer{
+        public:
+            group_varint_writer(std::vector<std::uint8_t> &controls, std::vector<std::uint8_t> &data) noexcept
+                : controls { controls }, data { data } { }
+
+            void push(std::uint32_t value){
+                if (n_pending == 0){
+                    controls.push_back(0);
+                }
+
+                const unsigned length = value < (1U << 8) ? 1 : value < (1U << 16) ? 2 : value < (1U << 24) ? 3 : 4;
+                controls.back() |= static_cast<std::uint8_t>((length - 1) << (2 * n_pending));
+                for (unsigned i = 0; i < length; ++i){
+                    data.push_back(static_cast<std::uint8_t>(value >> (8 * i)));
+                }
+                n_pending = (n_pending + 1) % 4;
+            }
+
+            // Pad the last group, so that the next value starts a new control byte.
+            void finish(){
+                while (n_pending != 0){
+                    push(0);
+                }
+            }
+
+        private:
+            std::vector<std::uint8_t> &controls, &data;
+            unsigned n_pending = 0;
+        };
+
+        class group_varint_reader{
+        public:
+            // \p data must be followed by at least 3 readable bytes.
+            group_varint_reader(const std::uint8_t *controls, const std::uint8_t *data) noexcept
+                : controls { controls }, data { data } { }
+
+            [[nodiscard]] std::uint32_t next() noexcept{
+                if (n_buffered == 0){
+                    decode_group();
+                }
+                return buffer[4 - n_buffered--];
+            }
+
+        private:
+            const std::uint8_t *controls, *data;
+            std::array<std::uint32_t, 4> buffer;
+            unsigned n_buffered = 0;
+
+            void decode_group() noexcept{
+                constexpr std::array<std::uint32_t, 4> masks { 0xffU, 0xffffU, 0xffffffU, 0xffffffffU };
+
+                const unsigned control = *controls++;
+                for (unsigned i = 0; i < 4; ++i){
+                    const unsigned length_code = (control >> (2 * i)) & 3U;
+                    // Little-endian load, which compiles to a single unaligned load on little-endian targets.
+                    const std::uint32_t word = static_cast<std::uint32_t>(data[0])
+                                             | static_cast<std::uint32_t>(data[1]) << 8
+                                             | static_cast<std::uint32_t>(data[2]) << 16
+                                             | static_cast<std::uint32_t>(data[3]) << 24;
+                    buffer[i] = word & masks[length_code];
+                    data += length_code + 1;
+                }
+                n_buffered = 4;
+            }
+        };
+
+        [[nodiscard]] constexpr std::uint32_t zigzag_encode(std::uint32_t delta) noexcept{
+            return (delta << 1) ^ static_cast<std::uint32_t>(-static_cast<std::int32_t>(delta >> 31));
+        }
+
+        [[nodiscard]] constexpr std::uint32_t zigzag_decode(std::uint32_t value) noexcept{
+            return (value >> 1) ^ static_cast<std::uint32_t>(-static_cast<std::int32_t>(value & 1));
+        }
+
+        // Unique colors and a palette index per element.
+        template <geometry::concepts::vec_type ColorT>
+        class color_palette{
+        public:
+            /**
+             * @param n Number of elements.
+             * @param optional Whether elements may have no color. Then index 0 means no color.
+             * @param color_of Function returning the color (or std::optional color) of an element.
+             */
+            template <typename Fn>
+            void encode(std::size_t n, bool optional, Fn &&color_of){
+                struct color_hash{
+                    std::size_t operator()(const ColorT &color) const noexcept{
+                        std::size_t seed = 0;
+                        [&]<std::size_t... Is>(std::index_sequence<Is...>){
+                            ((seed ^= std::hash<geometry::vec_value_t<ColorT>>{}(geometry::nth<Is>(color)) + 0x9e3779b97f4a7c15ull + (seed << 6) + (seed >> 2)), ...);
+                        }(std::make_index_sequence<geometry::vec_size_v<ColorT>>{});
+                        return seed;
+                    }
+                };
+                struct color_equal{
+                    bool operator()(const ColorT &lhs, const ColorT &rhs) const noexcept{
+                        return [&]<std::size_t... Is>(std::index_sequence<Is...>){
+                            return ((geometry::nth<Is>(lhs) == geometry::nth<Is>(rhs)) && ...);
+                        }(std::make_index_sequence<geometry::vec_size_v<ColorT>>{});
+                    }
+                };
+
+                has_optional = optional;
+                colors.clear();
+                std::unordered_map<ColorT, std::uint32_t, color_hash, color_equal> palette_indices;
+                std::vector<std::uint32_t> element_indices(n);
+                for (std::size_t i = 0; i < n; ++i){
+                    const std::optional<ColorT> color = color_of(i);
+                    if (!color){
+                        element_indices[i] = 0;
+                        continue;
+                    }
+
+                    const auto [it, inserted] = palette_indices.try_emplace(*color, static_cast<std::uint32_t>(colors.size() + optional));
+                    if (inserted){
+                        colors.push_back(*color);
+                    }
+                    element_indices[i] = it->second;
+                }
+
+                const std::size_t max_index = colors.size() + optional;
+                index_width = max_index <= 0x100 ? 1 : max_index <= 0x10000 ? 2 : 4;
+                indices.resize(n * index_width);
+                for (std::size_t i = 0; i < n; ++i){
+                    for (std::size_t b = 0; b < index_width; ++b){
+                        indices[i * index_width + b] = static_cast<std::uint8_t>(element_indices[i] >> (8 * b));
+                    }
+                }
+
+                colors.shrink_to_fit();
+            }
+
+            [[nodiscard]] std::optional<ColorT> operator[](std::size_t i) const noexcept{
+                std::uint32_t index = 0;
+                for (std::size_t b = 0; b < index_width; ++b){
+                    index |= static_cast<std::uint32_t>(indices[i * index_width + b]) << (8 * b);
+                }
+
+                if (has_optional){
+                    return index == 0 ? std::nullopt : std::optional { colors[index - 1] };
+                }
+                return colors[index];
+            }
+
+            [[nodiscard]] std::size_t byte_size() const noexcept{
+                return colors.capacity() * sizeof(ColorT) + indices.capacity();
+            }
+
+        private:
+            std::vector<ColorT> colors;
+            std::vector<std::uint8_t> indices;
+            std::size_t index_width = 1;
+            bool has_optional = false;
+        };
+
+        // Color of an element whose color is stored in it, as std::optional.
+        template <typename ElementT>
+        [[nodiscard]] auto element_color(const ElementT &element){
+            if constexpr (requires { element.color.has_value(); }){
+                return element.color;
+            }
+            else{
+                return std::optional { element.color };
+            }
+        }
+
+        struct no_palette {};
+
+        template <typename ColorT, bool Enabled>
+        using palette_if = std::conditional_t<Enabled, color_palette<ColorT>, no_palette>;
+    }
+
+    /**
+     * @brief Compact encoding of a mesh of type \p MeshT.
+     * @tparam MeshT Mesh type. A vertex type with color must be one of the library's colored vertex templates, since
+     * vertex_traits only allows writing colors.
+     */
+    template <geometry::concepts::mesh_type MeshT>
+        requires (geometry::vertex_color_kind_v<typename MeshT::vertex_type> == geometry::color_kind::none
+                  || concepts::instance_of_either<typename MeshT::vertex_type, geometry::colored_vertex, geometry::optional_colored_vertex, geometry::dense_optional_colored_vertex>)
+    class compressed_mesh{
+        using vertex_type = typename MeshT::vertex_type;
+        using face_type = typename MeshT::face_type;
+        using vertex_traits = geometry::vertex_traits<vertex_type>;
+
+        static constexpr geometry::color_kind vertex_color = geometry::vertex_color_kind_v<vertex_type>;
+        static constexpr bool has_vertex_color = vertex_color != geometry::color_kind::none;
+        static constexpr bool has_face_color = !concepts::instance_of<face_type, geometry::face>;
+
+        template <typename T>
+        struct color_type_of { using type = geometry::vec3<float>; };
+
+        template <typename T> requires requires { typename T::color_type; }
+        struct color_type_of<T> { using type = typename T::color_type; };
+
+    public:
+        /**
+         * @brief Encode \p mesh.
+         * @throw std::invalid_argument If \p options is invalid.
+         * @throw std::out_of_range If a face references a vertex index out of range, or the mesh has 2^32 or more
+         * vertices.
+         */
+        [[nodiscard]] static compressed_mesh encode(const MeshT &mesh, const compression_options &options = {}){
+            if (options.position_bits == 0 || options.position_bits > 16){
+                throw std::invalid_argument { "position_bits must be in [1, 16]." };
+            }
+            if (options.faces_per_block == 0){
+                throw std::invalid_argument { "faces_per_block must be positive." };
+            }
+            if (mesh.vertices.size() > std::numeric_limits<std::uint32_t>::max()){
+                throw std::out_of_range { "Too many vertices to encode." };
+            }
+
+            compressed_mesh result;
+            result.n_vertices = mesh.vertices.size();
+            result.n_faces = mesh.faces.size();
+            result.n_edges = mesh.n_edges;
+            result.faces_per_block = options.faces_per_block;
+            result.encode_positions(mesh, options.position_bits);
+            result.encode_faces(mesh);
+
+            if constexpr (has_vertex_color){
+                if constexpr (vertex_color == geometry::color_kind::dense_optional){
+                    result.vertex_palette.encode(mesh.vertices.size(), true, [&](std::size_t i) { return mesh.vertex_colors[i]; });
+                }
+                else{
+                    result.vertex_palette.encode(mesh.vertices.size(), vertex_color == geometry::color_kind::optional,
+                                                 [&](std::size_t i) { return details::element_color(mesh.vertices[i]); });
+                }
+            }
+            if constexpr (has_face_color){
+                if constexpr (concepts::instance_of<face_type, geometry::dense_optional_colored_face>){
+                    result.face_palette.encode(mesh.faces.size(), true, [&](std::size_t i) { return mesh.face_colors[i]; });
+                }
+                else{
+                    result.face_palette.encode(mesh.faces.size(), concepts::instance_of<face_type, geometry::optional_colored_face>,
+                                               [&](std::size_t i) { return details::element_color(mesh.faces[i]); });
+                }
+            }
+            return result;
+        }
+
+        [[nodiscard]] MeshT decode() const{
+            MeshT mesh;
+            decode_into(mesh);
+            return mesh;
+        }
+
+        /**
+         * @brief Decode into \p mesh, reusing its memory like parse_into.
+         */
+        void decode_into(MeshT &mesh) const{
+            mesh.n_edges = n_edges;
+
+            // Vertices.
+            mesh.vertices.resize(n_vertices);
+            details::parallel_for_chunks(n_vertices, 16384, [&](std::size_t, std::size_t begin, std::size_t end){
+                using value_type = geometry::vec_value_t<typename vertex_traits::position_type>;
+                for (std::size_t i = begin; i < end; ++i){
+                    auto &p = vertex_traits::position(mesh.vertices[i]);
+                    geometry::nth<0>(p) = static_cast<value_type>(origin[0] + step[0] * quantized_positions[0][i]);
+                    geometry::nth<1>(p) = static_cast<value_type>(origin[1] + step[1] * quantized_positions[1][i]);
+                    geometry::nth<2>(p) = static_cast<value_type>(origin[2] + step[2] * quantized_positions[2][i]);
+                }
+                if constexpr (vertex_color == geometry::color_kind::required){
+                    for (std::size_t i = begin; i < end; ++i){
+                        vertex_traits::set_color(mesh.vertices[i], *vertex_palette[i]);
+                    }
+                }
+                else if constexpr (vertex_color == geometry::color_kind::optional){
+                    for (std::size_t i = begin; i < end; ++i){
+                        vertex_traits::set_color(mesh.vertices[i], vertex_palette[i]);
+                    }
+                }
+            });
+            if constexpr (vertex_color == geometry::color_kind::dense_optional){
+                mesh.vertex_colors.clear();
+                mesh.vertex_colors.reserve(n_vertices);
+                for (std::size_t i = 0; i < n_vertices; ++i){
+                    mesh.vertex_colors.push_back(vertex_palette[i]);
+                }
+            }
+
+            // Faces, by blocks in parallel.
+            mesh.faces.resize(n_faces);
+            details::parallel_for(block_count(), 1, [&](std::size_t block){
+                decode_block(block, [&](std::size_t face_index, std::span<const std::uint32_t> indices){
+                    auto &face = mesh.faces[face_index];
+                    face.vertex_indices.assign(indices.begin(), indices.end());
+                    if constexpr (concepts::instance_of<face_type, geometry::colored_face>){
+                        face.color = *face_palette[face_index];
+                    }
+                    else if constexpr (concepts::instance_of<face_type, geometry::optional_colored_face>){
+                        face.color = face_palette[face_index];
+                    }
+                });
+            });
+            if constexpr (concepts::instance_of<face_type, geometry::dense_optional_colored_face>){
+                mesh.face_colors.clear();
+                mesh.face_colors.reserve(n_faces);
+                for (std::size_t i = 0; i < n_faces; ++i){
+                    mesh.face_colors.push_back(face_palette[i]);
+                }
+            }
+        }
+
+        /**
+         * @brief Invoke fn(face_index, std::span<const std::uint32_t> vertex_indices) for every face in order, decoding
+         * one block at a time.
+         */
+        template <typename Fn>
+        void for_each_face(Fn &&fn) const{
+            for (std::size_t block = 0; block < block_count(); ++block){
+                decode_block(block, fn);
+            }
+        }
+
+        /**
+         * @brief Invoke fn(const std::array<std::uint32_t, 3> &vertex_indices) for every triangle of the fan
+         * triangulation of the faces, in order.
+         */
+        template <typename Fn>
+        void for_each_triangle(Fn &&fn) const{
+            for_each_face([&](std::size_t, std::span<const std::uint32_t> indices){
+                for (std::size_t j = 2; j < indices.size(); ++j){
+                    fn(std::array { indices[0], indices[j - 1], indices[j] });
+                }
+            });
+        }
+
+        // Dequantized position of vertex \p i.
+        [[nodiscard]] geometry::vec3<double> position(std::size_t i) const noexcept{
+            return {
+                origin[0] + step[0] * quantized_positions[0][i],
+                origin[1] + step[1] * quantized_positions[1][i],
+                origin[2] + step[2] * quantized_positions[2][i],
+            };
+        }
+
+        // Largest distance between an encoded position and its decoded position, along each axis.
+        [[nodiscard]] geometry::vec3<double> max_position_error() const noexcept{
+            return { step[0] / 2, step[1] / 2, step[2] / 2 };
+        }
+
+        [[nodiscard]] std::size_t vertex_count() const noexcept{
+            return n_vertices;
+        }
+
+        [[nodiscard]] std::size_t face_count() const noexcept{
+            return n_faces;
+        }
+
+        // Number of heap and inline bytes owned by this object.
+        [[nodiscard]] std::size_t byte_size() const noexcept{
+            std::size_t result = sizeof(compressed_mesh)
+                               + 3 * quantized_positions[0].capacity() * sizeof(std::uint16_t)
+                               + face_sizes.capacity()
+                               + index_controls.capacity() + index_data.capacity()
+                               + block_offsets.capacity() * sizeof(block_offset);
+            if constexpr (has_vertex_color){
+                result += vertex_palette.byte_size();
+            }
+            if constexpr (has_face_color){
+                result += face_palette.byte_size();
+            }
+            return result;
+        }
+
+    private:
+        struct block_offset{
+            std::size_t control, data;
+        };
+
+        std::size_t n_vertices = 0, n_faces = 0, n_edges = 0;
+        std::size_t faces_per_block = 0;
+
+        std::array<double, 3> origin {}, step {};
+        std::array<std::vector<std::uint16_t>, 3> quantized_positions;
+
+        // Number of vertices of each face, or empty if every face has uniform_face_size vertices.
+        std::vector<std::uint8_t> face_sizes;
+        std::size_t uniform_face_size = 0;
+
+        std::vector<std::uint8_t> index_controls, index_data;
+        std::vector<block_offset> block_offsets;
+
+        [[no_unique_address]] details::palette_if<typename color_type_of<vertex_type>::type, has_vertex_color> vertex_palette;
+        [[no_unique_address]] details::palette_if<typename color_type_of<face_type>::type, has_face_color> face_palette;
+
+        [[nodiscard]] std::size_t block_count() const noexcept{
+            return block_offsets.size();
+        }
+
+        void encode_positions(const MeshT &mesh, unsigned position_bits){
+            std::array<double, 3> min, max;
+            min.fill(std::numeric_limits<double>::infinity());
+            max.fill(-std::numeric_limits<double>::infinity());
+            const auto coordinates_of = [](const vertex_type &vertex){
+                const auto &p = vertex_traits::position(vertex);
+                return std::array {
+                    static_cast<double>(geometry::nth<0>(p)), static_cast<double>(geometry::nth<1>(p)), static_cast<double>(geometry::nth<2>(p))
+                };
+            };
+            for (const auto &vertex : mesh.vertices){
+                const auto p = coordinates_of(vertex);
+                for (std::size_t axis = 0; axis < 3; ++axis){
+                    min[axis] = std::min(min[axis], p[axis]);
+                    max[axis] = std::max(max[axis], p[axis]);
+                }
+            }
+
+            const double levels = static_cast<double>((1U << position_bits) - 1);
+            for (std::size_t axis = 0; axis < 3; ++axis){
+                origin[axis] = mesh.vertices.empty() ? 0.0 : min[axis];
+                step[axis] = mesh.vertices.empty() ? 0.0 : (max[axis] - min[axis]) / levels;
+                quantized_positions[axis].resize(mesh.vertices.size());
+            }
+
+            details::parallel_for(mesh.vertices.size(), 16384, [&](std::size_t i){
+                const auto p = coordinates_of(mesh.vertices[i]);
+                for (std::size_t axis = 0; axis < 3; ++axis){
+                    quantized_positions[axis][i] = step[axis] == 0.0
+                        ? std::uint16_t { 0 }
+                        : static_cast<std::uint16_t>(std::clamp(std::lround((p[axis] - origin[axis]) / step[axis]), 0L, static_cast<long>(levels)));
+                }
+            });
+        }
+
+        void encode_faces(const MeshT &mesh){
+            uniform_face_size = mesh.faces.empty() ? 0 : mesh.faces.front().vertex_indices.size();
+            bool uniform = true;
+            for (const auto &face : mesh.faces){
+                if (face.vertex_indices.size() > std::numeric_limits<std::uint8_t>::max()){
+                    throw std::out_of_range { "Faces with more than 255 vertices cannot be encoded." };
+                }
+                uniform = uniform && face.vertex_indices.size() == uniform_face_size;
+            }
+            if (!uniform){
+                face_sizes.reserve(mesh.faces.size());
+                for (const auto &face : mesh.faces){
+                    face_sizes.push_back(static_cast<std::uint8_t>(face.vertex_indices.size()));
+                }
+            }
+
+            details::group_varint_writer writer { index_controls, index_data };
+            for (std::size_t first = 0; first < mesh.faces.size(); first += faces_per_block){
+                block_offsets.push_back({ index_controls.size(), index_data.size() });
+
+                std::uint32_t previous = 0; // Deltas restart at every block, so that blocks decode independently.
+                const std::size_t last = std::min(first + faces_per_block, mesh.faces.size());
+                for (std::size_t i = first; i < last; ++i){
+                    for (auto index : mesh.faces[i].vertex_indices){
+                        if (std::cmp_less(index, 0) || std::cmp_greater_equal(index, mesh.vertices.size())){
+                            throw std::out_of_range { "Face references a vertex index out of range." };
+                        }
+
+                        const auto current = static_cast<std::uint32_t>(index);
+                        writer.push(details::zigzag_encode(current - previous)); // Wraps around, and so does decoding.
+                        previous = current;
+                    }
+                }
+                writer.finish();
+            }
+
+            // Padding for the 4-byte loads of the reader.
+            index_data.insert(index_data.end(), 3, 0);
+            index_controls.shrink_to_fit();
+            index_data.shrink_to_fit();
+            block_offsets.shrink_to_fit();
+        }
+
+        template <typename Fn>
+        void decode_block(std::size_t block, Fn &&fn) const{
+            details::group_varint_reader reader {
+                index_controls.data() + block_offsets[block].control,
+                index_data.data() + block_offsets[block].data
+            };
+
+            std::array<std::uint32_t, std::numeric_limits<std::uint8_t>::max()> indices;
+            std::uint32_t previous = 0;
+            const std::size_t first = block * faces_per_block, last = std::min(first + faces_per_block, n_faces);
+            for (std::size_t i = first; i < last; ++i){
+                const std::size_t face_size = face_sizes.empty() ? uniform_face_size : face_sizes[i];
+                for (std::size_t j = 0; j < face_size; ++j){
+                    previous += details::zigzag_decode(reader.next());
+                    indices[j] = previous;
+                }
+                fn(i, std::span<const std::uint32_t> { indices.data(), face_size });
+            }
+        }
+    };
+}
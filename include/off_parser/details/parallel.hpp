@@ -0,0 +1,173 @@
+//
+// Created by gomkyung2 on 10/18/26.
+//
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <iterator>
+#include <thread>
+#include <vector>
+
+namespace off_parser::details{
+    [[nodiscard]] inline std::size_t hardware_concurrency() noexcept{
+        // std::thread::hardware_concurrency() may read the system files on every call.
+        static const std::size_t result = std::max(std::thread::hardware_concurrency(), 1U);
+        return result;
+    }
+
+    // Number of chunks parallel_for_chunks splits \p n elements into.
+    [[nodiscard]] inline std::size_t chunk_count(std::size_t n, std::size_t min_grain) noexcept{
+        return std::clamp<std::size_t>(n / std::max<std::size_t>(min_grain, 1), 1, hardware_concurrency());
+    }
+
+    // Number of helper threads running for all the parallel calls, so that nested or concurrent calls never run more
+    // than hardware_concurrency() threads together.
+    inline std::atomic<std::size_t> n_busy_workers = 0;
+
+    // Reservation of up to n helper threads from the shared budget, released on destruction.
+    class worker_reservation{
+    public:
+        explicit worker_reservation(std::size_t n) noexcept{
+            const std::size_t limit = hardware_concurrency() - 1;
+            std::size_t busy = n_busy_workers.load(std::memory_order_relaxed);
+            do{
+                count = std::min(n, limit - std::min(busy, limit));
+            } while (count != 0 && !n_busy_workers.compare_exchange_weak(busy, busy + count, std::memory_order_relaxed));
+        }
+
+        worker_reservation(const worker_reservation&) = delete;
+        worker_reservation &operator=(const worker_reservation&) = delete;
+
+        ~worker_reservation(){
+            n_busy_workers.fetch_sub(count, std::memory_order_relaxed);
+        }
+
+        [[nodiscard]] std::size_t size() const noexcept{
+            return count;
+        }
+
+    private:
+        std::size_t count;
+    };
+
+    /**
+     * @brief Split [0, \p n) into contiguous chunks of at least \p min_grain elements, and invoke fn(chunk_index, begin,
+     * end) for each chunk. The chunks are processed by the calling thread and as many helper threads as the shared
+     * budget allows, so the call runs serially when every hardware thread is busy.
+     * @return Number of chunks, which is at most hardware_concurrency().
+     * @note If any invocation throws, the first exception (in chunk order) is rethrown after all chunks are done.
+     */
+    template <typename Fn>
+    std::size_t parallel_for_chunks(std::size_t n, std::size_t min_grain, Fn &&fn){
+        const std::size_t n_chunks = chunk_count(n, min_grain);
+        if (n_chunks == 1){
+            fn(std::size_t { 0 }, std::size_t { 0 }, n);
+            return 1;
+        }
+
+        std::vector<std::exception_ptr> exceptions(n_chunks);
+        std::atomic<std::size_t> next_chunk = 0;
+        const auto run_chunks = [&](){
+            for (std::size_t chunk; (chunk = next_chunk.fetch_add(1, std::memory_order_relaxed)) < n_chunks;){
+                try{
+                    fn(chunk, n * chunk / n_chunks, n * (chunk + 1) / n_chunks);
+                }
+                catch (...){
+                    exceptions[chunk] = std::current_exception();
+                }
+            }
+        };
+
+        {
+            const worker_reservation reservation { n_chunks - 1 };
+            std::vector<std::jthread> workers;
+            workers.reserve(reservation.size());
+            for (std::size_t i = 0; i < reservation.size(); ++i){
+                workers.emplace_back(run_chunks);
+            }
+            run_chunks();
+        } // Join the workers.
+
+        for (const auto &exception : exceptions){
+            if (exception){
+                std::rethrow_exception(exception);
+            }
+        }
+        return n_chunks;
+    }
+
+    /**
+     * @brief Invoke \p fn1 and \p fn2, concurrently if a helper thread is available in the shared budget.
+     * @note If both throw, the exception of \p fn2 is propagated.
+     */
+    template <typename Fn1, typename Fn2>
+    void parallel_invoke(Fn1 &&fn1, Fn2 &&fn2){
+        const worker_reservation reservation { 1 };
+        if (reservation.size() == 0){
+            fn1();
+            fn2();
+            return;
+        }
+
+        std::exception_ptr exception;
+        {
+            std::jthread worker { [&](){
+                try{
+                    fn1();
+                }
+                catch (...){
+                    exception = std::current_exception();
+                }
+            } };
+            fn2();
+        } // Join the worker.
+
+        if (exception){
+            std::rethrow_exception(exception);
+        }
+    }
+
+    /**
+     * @brief Invoke fn(i) for every i in [0, \p n), concurrently in chunks of at least \p min_grain elements.
+     */
+    template <typename Fn>
+    void parallel_for(std::size_t n, std::size_t min_grain, Fn &&fn){
+        parallel_for_chunks(n, min_grain, [&](std::size_t, std::size_t begin, std::size_t end){
+            for (std::size_t i = begin; i < end; ++i){
+                fn(i);
+            }
+        });
+    }
+
+    /**
+     * @brief Sort [\p first, \p last) by \p comp: chunks of at least \p min_grain elements are sorted concurrently, and
+     * then merged pairwise, each level of merges concurrently.
+     * @note Not stable.
+     */
+    template <std::random_access_iterator It, typename Compare = std::ranges::less>
+    void parallel_sort(It first, It last, Compare comp = {}, std::size_t min_grain = 1 << 15){
+        const auto n = static_cast<std::size_t>(last - first);
+        const std::size_t n_chunks = parallel_for_chunks(n, min_grain, [&](std::size_t, std::size_t begin, std::size_t end){
+            std::sort(first + begin, first + end, comp);
+        });
+
+        // Chunk boundaries, as computed by parallel_for_chunks.
+        const auto bound = [&](std::size_t chunk){
+            return first + static_cast<std::ptrdiff_t>(n * chunk / n_chunks);
+        };
+        for (std::size_t width = 1; width < n_chunks; width *= 2){
+            parallel_for((n_chunks + 2 * width - 1) / (2 * width), 1, [&](std::size_t merge){
+                const std::size_t left = 2 * width * merge;
+                const std::size_t middle = std::min(left + width, n_chunks), right = std::min(left + 2 * width, n_chunks);
+                if (middle < right){
+                    std::inplace_merge(bound(left), bound(middle), bound(right), comp);
+                }
+            });
+        }
+    }
+}
@@ -0,0 +1,40 @@
+//
+// Created by gomkyung2 on 10/18/26.
+//
+
+#pragma once
+
+#include "../geometry/vec.hpp"
+
+namespace off_parser::details{
+    template <typename T>
+    [[nodiscard]] constexpr geometry::vec3<T> operator-(const geometry::vec3<T> &a, const geometry::vec3<T> &b) noexcept{
+        return { a.x - b.x, a.y - b.y, a.z - b.z };
+    }
+
+    template <typename T>
+    [[nodiscard]] constexpr geometry::vec3<T> operator+(const geometry::vec3<T> &a, const geometry::vec3<T> &b) noexcept{
+        return { a.x + b.x, a.y + b.y, a.z + b.z };
+    }
+
+    template <typename T>
+    [[nodiscard]] constexpr geometry::vec3<T> operator*(const geometry::vec3<T> &a, T s) noexcept{
+        return { a.x * s, a.y * s, a.z * s };
+    }
+
+    template <typename T>
+    [[nodiscard]] constexpr T dot(const geometry::vec3<T> &a, const geometry::vec3<T> &b) noexcept{
+        return a.x * b.x + a.y * b.y + a.z * b.z;
+    }
+
+    template <typename T>
+    [[nodiscard]] constexpr geometry::vec3<T> cross(const geometry::vec3<T> &a, const geometry::vec3<T> &b) noexcept{
+        return { a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x };
+    }
+
+    template <typename T>
+    [[nodiscard]] constexpr T distance_squared(const geometry::vec3<T> &a, const geometry::vec3<T> &b) noexcept{
+        const auto d = a - b;
+        return dot(d, d);
+    }
+}
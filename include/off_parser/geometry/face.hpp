@@ -18,25 +18,31 @@ namespace off_parser::geometry {
         std::vector<index_type> vertex_indices;
     };
 
-    template <std::integral T, concepts::vec_type ColorT>
+    template <std::integral T, concepts::color_vec_type ColorT>
     struct colored_face : face<T> {
         using color_type = ColorT;
 
         color_type color;
     };
 
-    template<std::integral T, concepts::vec_type ColorT>
+    template<std::integral T, concepts::color_vec_type ColorT>
     struct optional_colored_face : face<T> {
         using color_type = ColorT;
 
         std::optional<color_type> color;
     };
 
+    // Face whose optional color is stored in mesh::face_colors, instead of per face.
+    template<std::integral T, concepts::color_vec_type ColorT>
+    struct dense_optional_colored_face : face<T> {
+        using color_type = ColorT;
+    };
+
     namespace concepts{
         template <typename T>
         concept face_type = off_parser::concepts::instance_of_either<
             std::remove_cvref_t<T>,
-            face, colored_face, optional_colored_face
+            face, colored_face, optional_colored_face, dense_optional_colored_face
         >;
     }
 }
\ No newline at end of file
@@ -8,10 +8,41 @@
 
 #include "vertex.hpp"
 #include "face.hpp"
+#include "optional_color_array.hpp"
 
 #include "../concepts.hpp"
 
 namespace off_parser::geometry {
+    namespace details{
+        // Placeholders for the colors of the element types that store them per element. Distinct types, so that both
+        // take no space.
+        struct no_dense_vertex_colors {};
+        struct no_dense_face_colors {};
+
+        // Colors of the vertices of color_kind::dense_optional are stored in the mesh.
+        template <typename VertexT>
+        struct vertex_color_storage{
+            using type = no_dense_vertex_colors;
+        };
+
+        template <typename VertexT>
+            requires (vertex_color_kind_v<VertexT> == color_kind::dense_optional)
+        struct vertex_color_storage<VertexT>{
+            using type = optional_color_array<typename vertex_traits<VertexT>::color_type>;
+        };
+
+        // Colors of the dense_optional_colored_face are stored in the mesh.
+        template <typename FaceT>
+        struct face_color_storage{
+            using type = no_dense_face_colors;
+        };
+
+        template <typename IndexT, typename ColorT>
+        struct face_color_storage<dense_optional_colored_face<IndexT, ColorT>>{
+            using type = optional_color_array<ColorT>;
+        };
+    }
+
     // Mesh type.
     template <concepts::vertex_type VertexT, concepts::face_type FaceT>
     struct mesh{
@@ -21,6 +52,11 @@ namespace off_parser::geometry {
         std::vector<vertex_type> vertices;
         std::vector<face_type> faces;
         std::size_t n_edges;
+
+        // Last, so that the mesh can still be initialized as { vertices, faces, n_edges }. Empty unless the vertex or
+        // face type stores its colors in the mesh.
+        [[no_unique_address]] typename details::vertex_color_storage<VertexT>::type vertex_colors {};
+        [[no_unique_address]] typename details::face_color_storage<FaceT>::type face_colors {};
     };
 
     namespace concepts{
@@ -0,0 +1,141 @@
+//
+// Created by gomkyung2 on 10/18/26.
+//
+
+#pragma once
+
+#include <bit>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <vector>
+
+#include "vec.hpp"
+
+namespace off_parser::geometry {
+    /*
+     * Sequence of optional colors, stored densely.
+     *
+     * Only the present colors are stored, contiguously in element order. Presence of each element is recorded in a
+     * bitmap, which is dropped when either all or none of the elements have color (the common case for OFF files). The
+     * number of present colors before each bitmap word is cached, so element lookup is O(1).
+     */
+    template <concepts::vec_type ColorT>
+    class optional_color_array{
+    public:
+        using color_type = ColorT;
+
+        void reserve(std::size_t n){
+            colors.reserve(n);
+        }
+
+        void shrink_to_fit(){
+            colors.shrink_to_fit();
+            presence.shrink_to_fit();
+            ranks.shrink_to_fit();
+        }
+
+        void clear() noexcept{
+            colors.clear();
+            presence.clear();
+            ranks.clear();
+            n_elements = 0;
+        }
+
+        void push_back(const std::optional<color_type> &color){
+            // Materialize the bitmap when the sequence stops being all-or-nothing.
+            if (presence.empty() && n_elements != 0 && color.has_value() != all_present()){
+                materialize_presence();
+            }
+
+            if (!presence.empty()){
+                if (n_elements % 64 == 0){
+                    presence.push_back(0);
+                    ranks.push_back(static_cast<std::uint32_t>(colors.size()));
+                }
+                if (color){
+                    presence.back() |= std::uint64_t { 1 } << (n_elements % 64);
+                }
+            }
+
+            if (color){
+                colors.push_back(*color);
+            }
+            ++n_elements;
+        }
+
+        [[nodiscard]] std::size_t size() const noexcept{
+            return n_elements;
+        }
+
+        [[nodiscard]] bool empty() const noexcept{
+            return n_elements == 0;
+        }
+
+        [[nodiscard]] bool all_present() const noexcept{
+            return colors.size() == n_elements;
+        }
+
+        [[nodiscard]] bool none_present() const noexcept{
+            return colors.empty();
+        }
+
+        [[nodiscard]] bool has_value(std::size_t i) const noexcept{
+            if (presence.empty()){
+                return !colors.empty();
+            }
+            return (presence[i / 64] >> (i % 64)) & 1;
+        }
+
+        [[nodiscard]] std::optional<color_type> operator[](std::size_t i) const noexcept{
+            if (!has_value(i)){
+                return std::nullopt;
+            }
+            return colors[compact_index(i)];
+        }
+
+        /**
+         * @brief Present colors in element order. If all_present() is true, it can be indexed by the element index.
+         */
+        [[nodiscard]] std::span<const color_type> compact_colors() const noexcept{
+            return colors;
+        }
+
+        // Number of heap bytes owned, including the reserved capacity.
+        [[nodiscard]] std::size_t heap_bytes() const noexcept{
+            return colors.capacity() * sizeof(color_type)
+                 + presence.capacity() * sizeof(std::uint64_t)
+                 + ranks.capacity() * sizeof(std::uint32_t);
+        }
+
+    private:
+        std::vector<color_type> colors;
+        std::vector<std::uint64_t> presence;
+        std::vector<std::uint32_t> ranks;
+        std::size_t n_elements = 0;
+
+        [[nodiscard]] std::size_t compact_index(std::size_t i) const noexcept{
+            if (presence.empty()){
+                return i;
+            }
+
+            const std::uint64_t lower_bits = presence[i / 64] & ((std::uint64_t { 1 } << (i % 64)) - 1);
+            return ranks[i / 64] + static_cast<std::size_t>(std::popcount(lower_bits));
+        }
+
+        void materialize_presence(){
+            const bool present = all_present();
+            const std::size_t n_words = (n_elements + 63) / 64;
+            presence.resize(n_words, present ? ~std::uint64_t { 0 } : 0);
+            ranks.resize(n_words);
+            for (std::size_t word = 0; word < n_words; ++word){
+                ranks[word] = present ? static_cast<std::uint32_t>(word * 64) : 0;
+            }
+
+            // Clear the bits beyond the last element, which will be set by the following push_back calls.
+            if (const std::size_t n_used_bits = n_elements % 64; n_used_bits != 0){
+                presence.back() &= (std::uint64_t { 1 } << n_used_bits) - 1;
+            }
+        }
+    };
+}
@@ -0,0 +1,42 @@
+//
+// Created by gomkyung2 on 10/18/26.
+//
+
+#pragma once
+
+#include <array>
+#include <concepts>
+#include <cstddef>
+
+#include "vertex.hpp"
+
+namespace off_parser::geometry {
+    // Number of elements of a static_mesh, which is determined at compile time.
+    struct static_mesh_extent{
+        std::size_t n_vertices;
+        std::size_t n_faces;
+        std::size_t max_face_size;
+    };
+
+    // Face type with fixed capacity. Only the first n_vertices elements of vertex_indices are valid.
+    template <std::integral IndexT, std::size_t MaxSize>
+    struct static_face{
+        using index_type = IndexT;
+        static constexpr std::size_t capacity = MaxSize;
+
+        std::array<index_type, MaxSize> vertex_indices;
+        std::size_t n_vertices;
+    };
+
+    // Mesh type with fixed capacity, which can be constructed in constant evaluation.
+    template <concepts::vertex_type VertexT, std::integral IndexT, static_mesh_extent Extent>
+    struct static_mesh{
+        using vertex_type = VertexT;
+        using face_type = static_face<IndexT, Extent.max_face_size>;
+        static constexpr static_mesh_extent extent = Extent;
+
+        std::array<vertex_type, Extent.n_vertices> vertices;
+        std::array<face_type, Extent.n_faces> faces;
+        std::size_t n_edges;
+    };
+}
@@ -4,7 +4,10 @@
 
 #pragma once
 
+#include <array>
+#include <concepts>
 #include <cstddef>
+#include <type_traits>
 
 #include "../concepts.hpp"
 
@@ -26,45 +29,94 @@ namespace off_parser::geometry{
         T x, y, z, w;
     };
 
-    namespace concepts{
-        template <typename T>
-        concept vec_type = off_parser::concepts::instance_of_either<
-            std::remove_cvref_t<T>,
-            vec3, vec4
-        >;
-    }
+    /**
+     * Customization point for the vector types the parser reads into. Specialize it for your own type with:
+     * - value_type: component type.
+     * - size: number of components.
+     * - template <std::size_t I, typename V> static constexpr auto &get(V &v): I-th component of v, where V is the
+     *   vector type or its const-qualified type.
+     * Specializations for vec3, vec4, std::array and built-in arrays are provided. Built-in arrays can be used as position
+     * types, but not as color types.
+     */
+    template <typename T>
+    struct vec_traits;
 
-    template <std::size_t I, concepts::vec_type VecT>
-        requires (I < VecT::size)
-    [[nodiscard]] constexpr typename VecT::value_type &nth(VecT &v) noexcept {
-        if constexpr (I == 0) {
-            return v.x;
+    template <typename T>
+    struct vec_traits<vec3<T>>{
+        using value_type = T;
+        static constexpr std::size_t size = 3;
+
+        template <std::size_t I, typename V>
+        [[nodiscard]] static constexpr auto &get(V &v) noexcept{
+            if constexpr (I == 0) return v.x;
+            else if constexpr (I == 1) return v.y;
+            else return v.z;
         }
-        else if constexpr (I == 1) {
-            return v.y;
+    };
+
+    template <typename T>
+    struct vec_traits<vec4<T>>{
+        using value_type = T;
+        static constexpr std::size_t size = 4;
+
+        template <std::size_t I, typename V>
+        [[nodiscard]] static constexpr auto &get(V &v) noexcept{
+            if constexpr (I == 0) return v.x;
+            else if constexpr (I == 1) return v.y;
+            else if constexpr (I == 2) return v.z;
+            else return v.w;
         }
-        else if constexpr (I == 2) {
-            return v.z;
+    };
+
+    template <typename T, std::size_t N>
+    struct vec_traits<std::array<T, N>>{
+        using value_type = T;
+        static constexpr std::size_t size = N;
+
+        template <std::size_t I, typename V>
+        [[nodiscard]] static constexpr auto &get(V &v) noexcept{
+            return v[I];
         }
-        else if constexpr (I == 3) {
-            return v.w;
+    };
+
+    template <typename T, std::size_t N>
+    struct vec_traits<T[N]>{
+        using value_type = T;
+        static constexpr std::size_t size = N;
+
+        template <std::size_t I, typename V>
+        [[nodiscard]] static constexpr auto &get(V &v) noexcept{
+            return v[I];
         }
+    };
+
+    namespace concepts{
+        template <typename T>
+        concept vec_type = requires{
+            typename vec_traits<std::remove_cvref_t<T>>::value_type;
+            { vec_traits<std::remove_cvref_t<T>>::size } -> std::convertible_to<std::size_t>;
+        };
+
+        // Vector type of a color, which is passed and stored by value. Built-in arrays are not allowed.
+        template <typename T>
+        concept color_vec_type = vec_type<T> && !std::is_array_v<std::remove_cvref_t<T>>;
     }
 
+    template <concepts::vec_type VecT>
+    using vec_value_t = typename vec_traits<std::remove_cvref_t<VecT>>::value_type;
+
+    template <concepts::vec_type VecT>
+    inline constexpr std::size_t vec_size_v = vec_traits<std::remove_cvref_t<VecT>>::size;
+
     template <std::size_t I, concepts::vec_type VecT>
-        requires (I < VecT::size)
-    [[nodiscard]] constexpr const typename VecT::value_type &nth(const VecT &v) noexcept {
-        if constexpr (I == 0) {
-            return v.x;
-        }
-        else if constexpr (I == 1) {
-            return v.y;
-        }
-        else if constexpr (I == 2) {
-            return v.z;
-        }
-        else if constexpr (I == 3) {
-            return v.w;
-        }
+        requires (I < vec_size_v<VecT>)
+    [[nodiscard]] constexpr vec_value_t<VecT> &nth(VecT &v) noexcept {
+        return vec_traits<std::remove_cvref_t<VecT>>::template get<I>(v);
+    }
+
+    template <std::size_t I, concepts::vec_type VecT>
+        requires (I < vec_size_v<VecT>)
+    [[nodiscard]] constexpr const vec_value_t<VecT> &nth(const VecT &v) noexcept {
+        return vec_traits<std::remove_cvref_t<VecT>>::template get<I>(v);
     }
-}
\ No newline at end of file
+}
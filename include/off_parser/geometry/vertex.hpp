@@ -4,6 +4,7 @@
 
 #pragma once
 
+#include <concepts>
 #include <optional>
 
 #include "vec.hpp"
@@ -17,25 +18,162 @@ namespace off_parser::geometry{
         PositionT position;
     };
 
-    template <concepts::vec_type PositionT, concepts::vec_type ColorT>
+    template <concepts::vec_type PositionT, concepts::color_vec_type ColorT>
     struct colored_vertex : vertex<PositionT>{
         using color_type = ColorT;
 
         color_type color;
     };
 
-    template <concepts::vec_type PositionT, concepts::vec_type ColorT>
+    template <concepts::vec_type PositionT, concepts::color_vec_type ColorT>
     struct optional_colored_vertex : vertex<PositionT>{
         using color_type = ColorT;
 
         std::optional<color_type> color;
     };
 
+    // Vertex whose optional color is stored in mesh::vertex_colors, instead of per vertex.
+    template <concepts::vec_type PositionT, concepts::color_vec_type ColorT>
+    struct dense_optional_colored_vertex : vertex<PositionT>{
+        using color_type = ColorT;
+    };
+
+    // How an element stores its color.
+    enum class color_kind{
+        none,           // No color; colors in the input are ignored.
+        required,       // Every element has a color.
+        optional,       // Each element may have a color.
+        dense_optional, // Each element may have a color, stored in the mesh instead of the element.
+    };
+
+    /**
+     * Customization point for the vertex types the parser writes into, so that a mesh can be parsed directly into an
+     * application-specific layout (e.g. an interleaved GPU vertex). Specialize it for your own type with:
+     * - position_type: vec_type of the position.
+     * - static position_type &position(VertexT &v), and its const overload: reference to the position of v.
+     * - static constexpr color_kind color: how the vertex stores its color.
+     * - color_type: color_vec_type the color is parsed as, unless color is color_kind::none.
+     * - static void set_color(VertexT &v, const color_type &c) if color is color_kind::required, or
+     *   static void set_color(VertexT &v, const std::optional<color_type> &c) if color is color_kind::optional. The color
+     *   may be converted to any representation, e.g. packed RGBA8.
+     * - Optionally, static color_type get_color(const VertexT &v) if color is color_kind::required, or
+     *   static std::optional<color_type> get_color(const VertexT &v) if color is color_kind::optional. Required by
+     *   simplify, which interpolates the colors.
+     *
+     * Example:
+     * struct gpu_vertex { float position[3]; std::uint32_t rgba; };
+     *
+     * template <> struct off_parser::geometry::vertex_traits<gpu_vertex>{
+     *     using position_type = float[3];
+     *     using color_type = vec4<float>;
+     *     static constexpr color_kind color = color_kind::required;
+     *
+     *     static constexpr position_type &position(gpu_vertex &v) noexcept { return v.position; }
+     *     static constexpr const position_type &position(const gpu_vertex &v) noexcept { return v.position; }
+     *     static constexpr void set_color(gpu_vertex &v, const color_type &c) noexcept { v.rgba = pack_rgba8(c); }
+     *     static constexpr color_type get_color(const gpu_vertex &v) noexcept { return unpack_rgba8(v.rgba); }
+     * };
+     */
+    template <typename VertexT>
+    struct vertex_traits;
+
+    namespace details{
+        template <typename PositionT>
+        struct library_vertex_traits{
+            using position_type = PositionT;
+
+            template <typename V>
+            [[nodiscard]] static constexpr auto &position(V &v) noexcept{
+                return v.position;
+            }
+        };
+    }
+
+    template <typename PositionT>
+    struct vertex_traits<vertex<PositionT>> : details::library_vertex_traits<PositionT>{
+        static constexpr color_kind color = color_kind::none;
+    };
+
+    template <typename PositionT, typename ColorT>
+    struct vertex_traits<colored_vertex<PositionT, ColorT>> : details::library_vertex_traits<PositionT>{
+        using color_type = ColorT;
+        static constexpr color_kind color = color_kind::required;
+
+        static constexpr void set_color(colored_vertex<PositionT, ColorT> &v, const color_type &c) noexcept{
+            v.color = c;
+        }
+
+        [[nodiscard]] static constexpr const color_type &get_color(const colored_vertex<PositionT, ColorT> &v) noexcept{
+            return v.color;
+        }
+    };
+
+    template <typename PositionT, typename ColorT>
+    struct vertex_traits<optional_colored_vertex<PositionT, ColorT>> : details::library_vertex_traits<PositionT>{
+        using color_type = ColorT;
+        static constexpr color_kind color = color_kind::optional;
+
+        static constexpr void set_color(optional_colored_vertex<PositionT, ColorT> &v, const std::optional<color_type> &c) noexcept{
+            v.color = c;
+        }
+
+        [[nodiscard]] static constexpr const std::optional<color_type> &get_color(const optional_colored_vertex<PositionT, ColorT> &v) noexcept{
+            return v.color;
+        }
+    };
+
+    template <typename PositionT, typename ColorT>
+    struct vertex_traits<dense_optional_colored_vertex<PositionT, ColorT>> : details::library_vertex_traits<PositionT>{
+        using color_type = ColorT;
+        static constexpr color_kind color = color_kind::dense_optional;
+    };
+
     namespace concepts{
+        namespace details{
+            template <typename T, typename TraitsT>
+            concept vertex_color_settable = TraitsT::color == color_kind::none
+                || (color_vec_type<typename TraitsT::color_type> && (TraitsT::color == color_kind::dense_optional
+                    || (TraitsT::color == color_kind::required && requires(T &v, const typename TraitsT::color_type &c){
+                        TraitsT::set_color(v, c);
+                    })
+                    || (TraitsT::color == color_kind::optional && requires(T &v, const std::optional<typename TraitsT::color_type> &c){
+                        TraitsT::set_color(v, c);
+                    })));
+
+            template <typename T, typename TraitsT>
+            concept vertex_color_gettable = (TraitsT::color == color_kind::none || TraitsT::color == color_kind::dense_optional)
+                || (TraitsT::color == color_kind::required && requires(const T &v){
+                    { TraitsT::get_color(v) } -> std::convertible_to<typename TraitsT::color_type>;
+                })
+                || (TraitsT::color == color_kind::optional && requires(const T &v){
+                    { TraitsT::get_color(v) } -> std::convertible_to<std::optional<typename TraitsT::color_type>>;
+                });
+        }
+
+        template <typename T>
+        concept vertex_type = requires(std::remove_cvref_t<T> &v, const std::remove_cvref_t<T> &cv){
+            requires vec_type<typename vertex_traits<std::remove_cvref_t<T>>::position_type>;
+            { vertex_traits<std::remove_cvref_t<T>>::position(v) } -> std::same_as<typename vertex_traits<std::remove_cvref_t<T>>::position_type &>;
+            { vertex_traits<std::remove_cvref_t<T>>::position(cv) } -> std::same_as<const typename vertex_traits<std::remove_cvref_t<T>>::position_type &>;
+            { vertex_traits<std::remove_cvref_t<T>>::color } -> std::convertible_to<color_kind>;
+            requires details::vertex_color_settable<std::remove_cvref_t<T>, vertex_traits<std::remove_cvref_t<T>>>;
+        };
+
+        // Vertex type whose color, if stored in the vertex, can also be read through vertex_traits::get_color.
         template <typename T>
-        concept vertex_type = off_parser::concepts::instance_of_either<
-            std::remove_cvref_t<T>,
-            vertex, colored_vertex, optional_colored_vertex
-        >;
+        concept vertex_color_gettable = vertex_type<T>
+            && details::vertex_color_gettable<std::remove_cvref_t<T>, vertex_traits<std::remove_cvref_t<T>>>;
+    }
+
+    template <concepts::vertex_type VertexT>
+    using vertex_position_t = typename vertex_traits<std::remove_cvref_t<VertexT>>::position_type;
+
+    template <concepts::vertex_type VertexT>
+    inline constexpr color_kind vertex_color_kind_v = vertex_traits<std::remove_cvref_t<VertexT>>::color;
+
+    // Reference to the position of \p vertex.
+    template <concepts::vertex_type VertexT>
+    [[nodiscard]] constexpr decltype(auto) position_of(VertexT &vertex) noexcept{
+        return vertex_traits<std::remove_cvref_t<VertexT>>::position(vertex);
     }
-}
\ No newline at end of file
+}
@@ -0,0 +1,249 @@
+//
+// Created by gomkyung2 on 10/18/26.
+//
+
+// Incremental re-parsing of edited OFF files: only the chunks of element lines whose hash changed since the previous
+// load are decoded. Each element is expected on its own line.
+//
+// off_parser::incremental_parser<mesh_t> parser;
+// parser.load("asset.off");
+// const auto result = parser.load("asset.off"); // After an edit, decodes only the edited chunks.
+
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <istream>
+#include <stdexcept>
+#include <streambuf>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "parser.hpp"
+
+namespace off_parser{
+    namespace details{
+        // Read-only stream buffer over a character range, without copying it.
+        class memory_streambuf : public std::streambuf{
+        public:
+            explicit memory_streambuf(std::string_view data) noexcept{
+                char *begin = const_cast<char*>(data.data());
+                setg(begin, begin, begin + data.size());
+            }
+        };
+
+        /**
+         * @brief 64-bit FNV-1a over 8-byte words, then the remaining bytes.
+         * @note Every step is a bijection of the running hash, so changing a single word always changes the result.
+         */
+        [[nodiscard]] inline std::uint64_t hash_bytes(std::string_view bytes) noexcept{
+            constexpr std::uint64_t prime = 0x100000001b3ull;
+            std::uint64_t hash = 0xcbf29ce484222325ull ^ bytes.size();
+
+            std::size_t i = 0;
+            for (; i + sizeof(std::uint64_t) <= bytes.size(); i += sizeof(std::uint64_t)){
+                std::uint64_t word;
+                std::memcpy(&word, bytes.data() + i, sizeof(word));
+                hash = (hash ^ word) * prime;
+            }
+            for (; i < bytes.size(); ++i){
+                hash = (hash ^ static_cast<unsigned char>(bytes[i])) * prime;
+            }
+            return hash;
+        }
+    }
+
+    /**
+     * @brief Parser that keeps a mesh and updates it from edited versions of the same file.
+     * @tparam MeshT Mesh type. Element types storing their color in the mesh (color_kind::dense_optional and
+     * dense_optional_colored_face) are not supported, since their colors cannot be patched in place.
+     */
+    template <geometry::concepts::mesh_type MeshT>
+        requires (geometry::vertex_color_kind_v<typename MeshT::vertex_type> != geometry::color_kind::dense_optional)
+                 && (!concepts::instance_of<typename MeshT::face_type, geometry::dense_optional_colored_face>)
+    class incremental_parser{
+    public:
+        struct reload_result{
+            bool full_parse;                    // Whether the whole file was parsed.
+            std::size_t n_changed_vertex_chunks; // Number of re-decoded vertex chunks. 0 if full_parse.
+            std::size_t n_changed_face_chunks;   // Number of re-decoded face chunks. 0 if full_parse.
+        };
+
+        /**
+         * @param elements_per_chunk Number of elements in a chunk. Smaller chunks decode less on a small edit, but
+         * cost more memory and bookkeeping.
+         */
+        explicit incremental_parser(std::size_t elements_per_chunk = 1024)
+            : elements_per_chunk { elements_per_chunk } {
+            if (elements_per_chunk == 0){
+                throw std::invalid_argument { "elements_per_chunk must be positive." };
+            }
+        }
+
+        [[nodiscard]] const MeshT &mesh() const noexcept{
+            return parsed;
+        }
+
+        /**
+         * @brief Load OFF \p data, updating the mesh from the previous load if possible. If the element counts changed,
+         * the whole data is parsed again, reusing the memory of the mesh like parse_into.
+         * @note \p data is not referenced after the call.
+         */
+        reload_result load_data(std::string_view data){
+            const std::size_t header_end = find_header_end(data);
+            details::memory_streambuf header_buffer { data.substr(0, header_end) };
+            std::istream header_input { &header_buffer };
+            const off_header new_header = parse_header(header_input);
+
+            // Chunks of this load, swapped with the previous ones at the end.
+            std::vector<chunk> &new_vertex_chunks = next_vertex_chunks, &new_face_chunks = next_face_chunks;
+            new_vertex_chunks.clear();
+            new_face_chunks.clear();
+            std::size_t position = header_end;
+            const bool complete = split_chunks(data, position, new_header.n_vertices, new_vertex_chunks)
+                               && split_chunks(data, position, new_header.n_faces, new_face_chunks);
+
+            // Patch in place if the element counts are unchanged.
+            if (loaded && complete && has_complete_chunks
+                && new_header.n_vertices == header.n_vertices && new_header.n_faces == header.n_faces)
+            {
+                reload_result result { false, 0, 0 };
+                for (std::size_t i = 0; i < new_vertex_chunks.size(); ++i){
+                    if (new_vertex_chunks[i].hash != vertex_chunks[i].hash){
+                        decode_vertices(data, new_vertex_chunks[i], i * elements_per_chunk);
+                        ++result.n_changed_vertex_chunks;
+                    }
+                }
+                for (std::size_t i = 0; i < new_face_chunks.size(); ++i){
+                    if (new_face_chunks[i].hash != face_chunks[i].hash){
+                        decode_faces(data, new_face_chunks[i], i * elements_per_chunk);
+                        ++result.n_changed_face_chunks;
+                    }
+                }
+
+                parsed.n_edges = new_header.n_edges;
+                header = new_header;
+                std::swap(vertex_chunks, next_vertex_chunks);
+                std::swap(face_chunks, next_face_chunks);
+                return result;
+            }
+
+            details::memory_streambuf buffer { data };
+            std::istream input { &buffer };
+            parse_into(parsed, input);
+
+            loaded = true;
+            has_complete_chunks = complete;
+            header = new_header;
+            std::swap(vertex_chunks, next_vertex_chunks);
+            std::swap(face_chunks, next_face_chunks);
+            return { true, 0, 0 };
+        }
+
+        /**
+         * @brief Load the OFF file at \p path, updating the mesh from the previous load if possible.
+         * @throw std::runtime_error If the file cannot be read.
+         */
+        reload_result load(const std::filesystem::path &path){
+            std::ifstream input { path, std::ios::binary };
+            if (!input){
+                throw std::runtime_error { "Failed to open " + path.string() };
+            }
+
+            // Reuse the file buffer across loads.
+            file_data.resize(static_cast<std::size_t>(std::filesystem::file_size(path)));
+            if (!input.read(file_data.data(), static_cast<std::streamsize>(file_data.size()))){
+                throw std::runtime_error { "Failed to read " + path.string() };
+            }
+            return load_data(file_data);
+        }
+
+    private:
+        struct chunk{
+            std::size_t begin, end; // Byte range of the chunk's lines, including the interleaved comments.
+            std::uint64_t hash;
+        };
+
+        std::size_t elements_per_chunk;
+
+        MeshT parsed {};
+        bool loaded = false;
+        bool has_complete_chunks = false; // False if the file had fewer element lines than its header counts.
+        off_header header {};
+        std::vector<chunk> vertex_chunks, face_chunks;
+        std::vector<chunk> next_vertex_chunks, next_face_chunks;
+        std::string file_data;
+
+        // Offset of the line after \p position in \p data, or the end of data.
+        [[nodiscard]] static std::size_t next_line(std::string_view data, std::size_t position) noexcept{
+            const std::size_t newline = data.find('\n', position);
+            return newline == std::string_view::npos ? data.size() : newline + 1;
+        }
+
+        // Whether the line at \p position is skipped by ignore_comment_or_empty_lines.
+        [[nodiscard]] static bool is_comment_or_empty(std::string_view data, std::size_t position) noexcept{
+            return data[position] == '\n' || data[position] == '#';
+        }
+
+        // Offset where the element lines start, following parse_header.
+        [[nodiscard]] static std::size_t find_header_end(std::string_view data) noexcept{
+            std::size_t position = next_line(data, 0);
+            while (position < data.size() && is_comment_or_empty(data, position)){
+                position = next_line(data, position);
+            }
+            return next_line(data, position);
+        }
+
+        /**
+         * @brief Split the next \p n_elements element lines from \p position into chunks, advancing \p position.
+         * @return Whether \p data had enough element lines.
+         */
+        bool split_chunks(std::string_view data, std::size_t &position, std::size_t n_elements, std::vector<chunk> &chunks) const{
+            chunks.reserve((n_elements + elements_per_chunk - 1) / elements_per_chunk);
+            for (std::size_t first = 0; first < n_elements; first += elements_per_chunk){
+                const std::size_t begin = position;
+                const std::size_t count = std::min(elements_per_chunk, n_elements - first);
+                for (std::size_t i = 0; i < count; ++i){
+                    while (position < data.size() && is_comment_or_empty(data, position)){
+                        position = next_line(data, position);
+                    }
+                    if (position == data.size()){
+                        return false;
+                    }
+                    position = next_line(data, position);
+                }
+                chunks.push_back({ begin, position, details::hash_bytes(data.substr(begin, position - begin)) });
+            }
+            return true;
+        }
+
+        void decode_vertices(std::string_view data, const chunk &c, std::size_t first){
+            details::memory_streambuf buffer { data.substr(c.begin, c.end - c.begin) };
+            std::istream input { &buffer };
+
+            const std::size_t last = std::min(first + elements_per_chunk, parsed.vertices.size());
+            for (std::size_t i = first; i < last; ++i){
+                ignore_comment_or_empty_lines(input);
+                parse_vertex(input, parsed.vertices[i]);
+                ignore_until_newline(input);
+            }
+        }
+
+        void decode_faces(std::string_view data, const chunk &c, std::size_t first){
+            details::memory_streambuf buffer { data.substr(c.begin, c.end - c.begin) };
+            std::istream input { &buffer };
+
+            const std::size_t last = std::min(first + elements_per_chunk, parsed.faces.size());
+            for (std::size_t i = first; i < last; ++i){
+                ignore_comment_or_empty_lines(input);
+                parsed.faces[i].vertex_indices.clear();
+                parse_face(input, parsed.faces[i]);
+                ignore_until_newline(input);
+            }
+        }
+    };
+}
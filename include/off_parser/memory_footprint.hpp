@@ -0,0 +1,30 @@
+//
+// Created by gomkyung2 on 10/18/26.
+//
+
+#pragma once
+
+#include "geometry/mesh.hpp"
+#include "concepts.hpp"
+
+namespace off_parser{
+    /**
+     * @brief Number of heap and inline bytes owned by \p mesh, including the reserved capacity.
+     */
+    template <geometry::concepts::mesh_type MeshT>
+    [[nodiscard]] std::size_t memory_footprint(const MeshT &mesh) noexcept{
+        std::size_t result = sizeof(MeshT)
+                           + mesh.vertices.capacity() * sizeof(typename MeshT::vertex_type)
+                           + mesh.faces.capacity() * sizeof(typename MeshT::face_type);
+        for (const auto &face : mesh.faces){
+            result += face.vertex_indices.capacity() * sizeof(typename MeshT::face_type::index_type);
+        }
+        if constexpr (geometry::vertex_color_kind_v<typename MeshT::vertex_type> == geometry::color_kind::dense_optional){
+            result += mesh.vertex_colors.heap_bytes();
+        }
+        if constexpr (concepts::instance_of<typename MeshT::face_type, geometry::dense_optional_colored_face>){
+            result += mesh.face_colors.heap_bytes();
+        }
+        return result;
+    }
+}
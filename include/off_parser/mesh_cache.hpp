@@ -0,0 +1,190 @@
+//
+// Created by gomkyung2 on 10/18/26.
+//
+
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <future>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <typeindex>
+#include <unordered_map>
+
+#include "parser.hpp"
+#include "memory_footprint.hpp"
+
+namespace off_parser{
+    // Thread-safe cache of parsed meshes, keyed by file path, last modification time and mesh type. Concurrent
+    // requests for the same key share a single parse, and meshes are evicted in least-recently-used order.
+    class mesh_cache{
+    public:
+        struct statistics{
+            std::uint64_t hits;         // Requests served by a parsed or in-flight mesh.
+            std::uint64_t misses;       // Requests that parsed the file.
+            std::uint64_t evictions;    // Meshes removed to fit in the capacity.
+            std::size_t n_entries;      // Number of cached meshes, including in-flight ones.
+            std::size_t bytes;          // Total memory footprint of the parsed meshes.
+        };
+
+        explicit mesh_cache(std::size_t capacity_bytes) noexcept : capacity_bytes { capacity_bytes } { }
+
+        mesh_cache(const mesh_cache&) = delete;
+        mesh_cache &operator=(const mesh_cache&) = delete;
+
+        /**
+         * @brief Get the parsed mesh of \p path, parsing it if not cached.
+         * @tparam MeshT Mesh type to be parsed.
+         * @param path Path of the OFF file.
+         * @return Shared immutable mesh. It is not cached if its memory footprint exceeds the capacity, or if the file
+         * is modified during the parse.
+         * @throw std::filesystem::filesystem_error If the file status cannot be read.
+         * @throw std::runtime_error If the file cannot be opened or parsed. Exceptions thrown while parsing or caching
+         * are propagated to every request waiting on the same parse, and nothing is cached.
+         */
+        template <geometry::concepts::mesh_type MeshT>
+        [[nodiscard]] std::shared_ptr<const MeshT> load(const std::filesystem::path &path){
+            key entry_key {
+                std::filesystem::absolute(path).lexically_normal().string(),
+                std::filesystem::last_write_time(path),
+                std::type_index { typeid(MeshT) }
+            };
+
+            std::unique_lock lock { mutex };
+            if (auto it = entries.find(entry_key); it != entries.end()){
+                ++n_hits;
+                entry &found = it->second;
+                if (found.ready){
+                    lru.splice(lru.begin(), lru, found.lru_position);
+                }
+
+                // Wait outside the lock if it is in flight.
+                std::shared_future<std::shared_ptr<const void>> future = found.future;
+                lock.unlock();
+                return std::static_pointer_cast<const MeshT>(future.get());
+            }
+
+            ++n_misses;
+            std::promise<std::shared_ptr<const void>> promise;
+            const std::uint64_t id = next_id++;
+            entries.emplace(entry_key, entry { promise.get_future().share(), id });
+            lock.unlock();
+
+            std::shared_ptr<const MeshT> mesh;
+            try{
+                std::ifstream input { path };
+                if (!input){
+                    throw std::runtime_error { "Failed to open " + path.string() };
+                }
+                mesh = std::make_shared<const MeshT>(parse<MeshT>(std::move(input)));
+                if (input.fail()){
+                    throw std::runtime_error { "Failed to parse " + path.string() + "; it is malformed or incomplete." };
+                }
+
+                // A mesh parsed from a file modified meanwhile may not match entry_key.mtime, and a mesh larger than
+                // the capacity would evict every other entry before itself.
+                std::error_code error;
+                const bool unmodified = std::filesystem::last_write_time(path, error) == entry_key.mtime && !error;
+                const std::size_t bytes = memory_footprint(*mesh);
+
+                std::lock_guard guard { mutex };
+                // The entry may also be removed by clear() during the parse. In every case, the result is still returned.
+                if (auto it = entries.find(entry_key); it != entries.end() && it->second.id == id){
+                    if (unmodified && bytes <= capacity_bytes){
+                        entry &inserted = it->second;
+                        inserted.lru_position = lru.insert(lru.begin(), entry_key); // The only step that may throw.
+                        inserted.ready = true;
+                        inserted.bytes = bytes;
+                        total_bytes += inserted.bytes;
+                        evict_to_capacity();
+                    }
+                    else{
+                        entries.erase(it);
+                    }
+                }
+            }
+            catch (...){
+                // Remove the entry, so that the waiters and the later requests do not see a broken promise.
+                lock.lock();
+                if (auto it = entries.find(entry_key); it != entries.end() && it->second.id == id){
+                    entries.erase(it);
+                }
+                lock.unlock();
+
+                promise.set_exception(std::current_exception());
+                throw;
+            }
+
+            promise.set_value(mesh);
+            return mesh;
+        }
+
+        [[nodiscard]] statistics stats() const{
+            std::lock_guard lock { mutex };
+            return { n_hits, n_misses, n_evictions, entries.size(), total_bytes };
+        }
+
+        // Remove every parsed mesh. In-flight parses are completed but not cached.
+        void clear(){
+            std::lock_guard lock { mutex };
+            entries.clear();
+            lru.clear();
+            total_bytes = 0;
+        }
+
+    private:
+        struct key{
+            std::string path;
+            std::filesystem::file_time_type mtime;
+            std::type_index type;
+
+            bool operator==(const key&) const = default;
+        };
+
+        struct key_hash{
+            std::size_t operator()(const key &k) const noexcept{
+                std::size_t seed = std::hash<std::string>{}(k.path);
+                const auto combine = [&](std::size_t value){
+                    seed ^= value + 0x9e3779b97f4a7c15ull + (seed << 6) + (seed >> 2);
+                };
+                combine(std::hash<std::filesystem::file_time_type::rep>{}(k.mtime.time_since_epoch().count()));
+                combine(k.type.hash_code());
+                return seed;
+            }
+        };
+
+        struct entry{
+            std::shared_future<std::shared_ptr<const void>> future;
+            std::uint64_t id; // Distinguishes an entry from the one re-inserted with the same key after removal.
+            bool ready = false;
+            std::size_t bytes = 0;
+            std::list<key>::iterator lru_position {};
+        };
+
+        std::size_t capacity_bytes;
+
+        mutable std::mutex mutex;
+        std::unordered_map<key, entry, key_hash> entries;
+        std::list<key> lru; // Parsed entries, most recently used first. In-flight entries are not evictable.
+        std::size_t total_bytes = 0;
+        std::uint64_t next_id = 0;
+        std::uint64_t n_hits = 0, n_misses = 0, n_evictions = 0;
+
+        void evict_to_capacity(){
+            while (total_bytes > capacity_bytes && !lru.empty()){
+                auto it = entries.find(lru.back());
+                total_bytes -= it->second.bytes;
+                entries.erase(it);
+                lru.pop_back();
+                ++n_evictions;
+            }
+        }
+    };
+}
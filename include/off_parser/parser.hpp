@@ -6,6 +6,13 @@
 
 #include <istream>
 #include <array>
+#include <charconv>
+#include <concepts>
+#include <limits>
+#include <optional>
+#include <stdexcept>
+#include <system_error>
+#include <utility>
 
 #include "geometry/mesh.hpp"
 #include "concepts.hpp"
@@ -14,7 +21,10 @@
 
 namespace off_parser{
     static void ignore_until_newline(std::istream &input){
-        input.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+        // At the end of input (the last line has no newline), ignore would set failbit.
+        if (!input.eof()){
+            input.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+        }
     }
 
     static void ignore_comment_or_empty_lines(std::istream &input){
@@ -32,99 +42,282 @@ namespace off_parser{
         }
     }
 
+    namespace details{
+        /**
+         * @brief Extract a number from \p input like operator>>, but with std::from_chars, since libstdc++'s floating
+         * point extraction allocates a string for every number.
+         * @note The number must be followed by a whitespace, '#' or the end of input. On failure, failbit of \p input is
+         * set and \p value is unspecified.
+         */
+        template <typename T>
+            requires (std::integral<T> || std::floating_point<T>) && (!std::same_as<T, bool>)
+        void read_number(std::istream &input, T &value){
+            const std::istream::sentry sentry { input }; // Skips the leading whitespaces.
+            if (!sentry){
+                return;
+            }
+
+            // Enough for any number in practice; longer tokens are rejected.
+            std::array<char, 128> token;
+            std::size_t length = 0;
+
+            std::streambuf &buffer = *input.rdbuf();
+            int c = buffer.sgetc();
+            for (; c != std::char_traits<char>::eof(); c = buffer.snextc()){
+                if (c == ' ' || c == '\n' || c == '\t' || c == '\r' || c == '\v' || c == '\f' || c == '#'){
+                    break;
+                }
+                if (length == token.size()){
+                    input.setstate(std::ios::failbit);
+                    return;
+                }
+                token[length++] = static_cast<char>(c);
+            }
+            if (c == std::char_traits<char>::eof()){
+                input.setstate(std::ios::eofbit);
+            }
+
+            // Unlike operator>>, std::from_chars does not accept the plus sign.
+            const char *first = token.data(), *last = token.data() + length;
+            if (first != last && *first == '+'){
+                ++first;
+            }
+            if (const auto [ptr, ec] = std::from_chars(first, last, value); first == last || ec != std::errc{} || ptr != last){
+                input.setstate(std::ios::failbit);
+            }
+        }
+    }
+
+    template <geometry::concepts::vec_type VecT>
+    void parse_vec_into(std::istream &input, VecT &result){
+        OFF_PARSER_INDEX_SEQUENCE(Is, geometry::vec_size_v<VecT>,
+            (details::read_number(input, geometry::nth<Is>(result)), ...);
+        );
+    }
+
     template <geometry::concepts::vec_type VecT>
     [[nodiscard]] VecT parse_vec(std::istream &input){
         VecT result;
-        OFF_PARSER_INDEX_SEQUENCE(Is, VecT::size,
-            (input >> ... >> geometry::nth<Is>(result));
-        );
+        parse_vec_into(input, result);
         return result;
     }
 
     template <geometry::concepts::vec_type VecT>
     [[nodiscard]] std::optional<VecT> parse_vec_within_line(std::istream &input){
-        std::array<typename VecT::value_type, VecT::size> buffer;
+        std::array<geometry::vec_value_t<VecT>, geometry::vec_size_v<VecT>> buffer;
         for (auto &elem : buffer){
-            if (input.peek() == '\n'){
+            if (input.eof() || input.peek() == '\n'){
                 return std::nullopt;
             }
 
-            input >> elem;
+            details::read_number(input, elem);
         }
 
-        return std::make_from_tuple<VecT>(buffer);
+        std::optional<VecT> result { std::in_place };
+        OFF_PARSER_INDEX_SEQUENCE(Is, geometry::vec_size_v<VecT>,
+            ((geometry::nth<Is>(*result) = buffer[Is]), ...);
+        );
+        return result;
     }
 
-    template <geometry::concepts::mesh_type MeshT>
-    MeshT parse(std::istream &&input){
+    // Element counts in the OFF header.
+    struct off_header{
+        std::size_t n_vertices;
+        std::size_t n_faces;
+        std::size_t n_edges;
+    };
+
+    namespace concepts{
+        // Receiver of parse_stream. Every element is passed by const reference, and is only valid during the call.
+        template <typename T, typename VertexT, typename FaceT>
+        concept parse_handler = requires(T handler, const off_header &header, const VertexT &vertex, const FaceT &face){
+            handler.on_header(header);
+            handler.on_vertex(vertex);
+            handler.on_face(face);
+        };
+    }
+
+    /**
+     * @brief Parse the header lines of an OFF file.
+     * @throw std::runtime_error If the element counts cannot be read.
+     */
+    [[nodiscard]] inline off_header parse_header(std::istream &input){
         // Ignore the first line (header).
         ignore_until_newline(input);
 
         ignore_comment_or_empty_lines(input);
 
         // Read number of vertices, faces, and edges.
-        std::size_t n_vertices, n_faces;
-        MeshT mesh;
-        input >> n_vertices >> n_faces >> mesh.n_edges;
-
-        // Reserve memory for vertices and faces.
-        mesh.vertices.reserve(n_vertices);
-        mesh.faces.reserve(n_faces);
+        off_header header {};
+        input >> header.n_vertices >> header.n_faces >> header.n_edges;
+        if (input.fail()){
+            throw std::runtime_error { "Failed to read the element counts of the OFF header." };
+        }
 
         ignore_until_newline(input);
 
-        // Parse vertices.
-        for (std::size_t i = 0; i < n_vertices; ++i){
-            ignore_comment_or_empty_lines(input);
+        return header;
+    }
 
-            typename MeshT::vertex_type vertex;
+    /**
+     * @brief Parse a vertex line, except its trailing newline. Fields are written through geometry::vertex_traits.
+     * @note Color of a color_kind::dense_optional vertex is not parsed, since it is stored in the mesh.
+     */
+    template <geometry::concepts::vertex_type VertexT>
+    void parse_vertex(std::istream &input, VertexT &vertex){
+        using traits = geometry::vertex_traits<VertexT>;
 
-            // Parse position.
-            vertex.position = parse_vec<typename MeshT::vertex_type::position_type>(input);
+        // Parse position.
+        parse_vec_into(input, traits::position(vertex));
 
-            // Parse color if vertex type contains color field.
-            if constexpr (concepts::instance_of<typename MeshT::vertex_type, geometry::colored_vertex>){
-                vertex.color = parse_vec<typename MeshT::vertex_type::color_type>(input);
-            }
-            else if constexpr (concepts::instance_of<typename MeshT::vertex_type, geometry::optional_colored_vertex>){
-                vertex.color = parse_vec_within_line<typename MeshT::vertex_type::color_type>(input);
+        // Parse color if vertex type contains color field.
+        if constexpr (traits::color == geometry::color_kind::required){
+            traits::set_color(vertex, parse_vec<typename traits::color_type>(input));
+        }
+        else if constexpr (traits::color == geometry::color_kind::optional){
+            traits::set_color(vertex, parse_vec_within_line<typename traits::color_type>(input));
+        }
+    }
+
+    /**
+     * @brief Parse a face line, except its trailing newline. Indices are appended to \p face.vertex_indices.
+     * @note Color of dense_optional_colored_face is not parsed, since it is stored in the mesh.
+     */
+    template <geometry::concepts::face_type FaceT>
+    void parse_face(std::istream &input, FaceT &face){
+        std::size_t n_vertices_in_face = 0;
+        details::read_number(input, n_vertices_in_face);
+        if (input.fail()){
+            return;
+        }
+
+        face.vertex_indices.reserve(n_vertices_in_face);
+
+        // Parse positions.
+        for (std::size_t j = 0; j < n_vertices_in_face && input.peek() != '\n'; ++j){
+            typename FaceT::index_type index {};
+            details::read_number(input, index);
+            if (input.fail()){
+                return;
             }
+            face.vertex_indices.push_back(index);
+        }
 
-            mesh.vertices.push_back(vertex);
+        // Parse color if vertex type contains color field.
+        if constexpr (concepts::instance_of<FaceT, geometry::colored_face>){
+            face.color = parse_vec<typename FaceT::color_type>(input);
+        }
+        else if constexpr (concepts::instance_of<FaceT, geometry::optional_colored_face>){
+            face.color = parse_vec_within_line<typename FaceT::color_type>(input);
+        }
+    }
+
+    /**
+     * @brief Parse OFF \p input into \p mesh, reusing the memory it already owns. The vertex and face vectors, the index
+     * vector of every face and the dense color storage keep their capacity, so reloading a mesh that is not larger than
+     * the previous one performs no heap allocation.
+     * @note Faces beyond the new face count are destroyed, with their index storage.
+     */
+    template <geometry::concepts::mesh_type MeshT>
+    void parse_into(MeshT &mesh, std::istream &input){
+        const off_header header = parse_header(input);
+        mesh.n_edges = header.n_edges;
+
+        // Parse vertices, in place.
+        mesh.vertices.resize(header.n_vertices);
+        if constexpr (geometry::vertex_color_kind_v<typename MeshT::vertex_type> == geometry::color_kind::dense_optional){
+            mesh.vertex_colors.clear();
+            mesh.vertex_colors.reserve(header.n_vertices);
+        }
+        for (auto &vertex : mesh.vertices){
+            ignore_comment_or_empty_lines(input);
+
+            parse_vertex(input, vertex);
+            if constexpr (geometry::vertex_color_kind_v<typename MeshT::vertex_type> == geometry::color_kind::dense_optional){
+                mesh.vertex_colors.push_back(parse_vec_within_line<typename geometry::vertex_traits<typename MeshT::vertex_type>::color_type>(input));
+            }
 
             ignore_until_newline(input);
         }
 
-        // Parse faces.
-        for (std::size_t i = 0; i < n_faces; ++i){
+        // Parse faces, in place. Clearing the index vector keeps its capacity.
+        mesh.faces.resize(header.n_faces);
+        if constexpr (concepts::instance_of<typename MeshT::face_type, geometry::dense_optional_colored_face>){
+            mesh.face_colors.clear();
+            mesh.face_colors.reserve(header.n_faces);
+        }
+        for (auto &face : mesh.faces){
             ignore_comment_or_empty_lines(input);
 
-            std::size_t n_vertices_in_face;
-            input >> n_vertices_in_face;
+            face.vertex_indices.clear();
+            parse_face(input, face);
+            if constexpr (concepts::instance_of<typename MeshT::face_type, geometry::dense_optional_colored_face>){
+                mesh.face_colors.push_back(parse_vec_within_line<typename MeshT::face_type::color_type>(input));
+            }
 
-            typename MeshT::face_type face;
-            face.vertex_indices.reserve(n_vertices_in_face);
+            ignore_until_newline(input);
+        }
+    }
 
-            // Parse positions.
-            for (std::size_t j = 0; j < n_vertices_in_face && input.peek() != '\n'; ++j){
-                typename MeshT::face_type::index_type index;
-                input >> index;
-                face.vertex_indices.push_back(index);
-            }
+    template <geometry::concepts::mesh_type MeshT>
+    void parse_into(MeshT &mesh, std::istream &&input){
+        parse_into(mesh, input);
+    }
 
-            // Parse color if vertex type contains color field.
-            if constexpr (concepts::instance_of<typename MeshT::face_type, geometry::colored_face>){
-                face.color = parse_vec<typename MeshT::face_type::color_type>(input);
-            }
-            else if constexpr (concepts::instance_of<typename MeshT::face_type, geometry::optional_colored_face>){
-                face.color = parse_vec_within_line<typename MeshT::face_type::color_type>(input);
-            }
+    template <geometry::concepts::mesh_type MeshT>
+    MeshT parse(std::istream &&input){
+        MeshT mesh;
+        parse_into(mesh, input);
+
+        // Release the reserved memory of absent colors.
+        if constexpr (geometry::vertex_color_kind_v<typename MeshT::vertex_type> == geometry::color_kind::dense_optional){
+            mesh.vertex_colors.shrink_to_fit();
+        }
+        if constexpr (concepts::instance_of<typename MeshT::face_type, geometry::dense_optional_colored_face>){
+            mesh.face_colors.shrink_to_fit();
+        }
+
+        return mesh;
+    }
+
+    /**
+     * @brief Parse OFF \p input without materializing the mesh: each element is passed to \p handler as soon as it is
+     * parsed. A single vertex and face object is reused for all elements, so memory usage does not depend on the size
+     * of the input.
+     * @tparam VertexT Vertex type. color_kind::dense_optional is not supported, use optional_colored_vertex instead.
+     * @tparam FaceT Face type. dense_optional_colored_face is not supported, use optional_colored_face instead.
+     * @param input Input stream.
+     * @param handler Receiver of the header, vertices and faces, in this order.
+     */
+    template <geometry::concepts::vertex_type VertexT, geometry::concepts::face_type FaceT, typename HandlerT>
+        requires concepts::parse_handler<HandlerT &, VertexT, FaceT>
+                 && (geometry::vertex_color_kind_v<VertexT> != geometry::color_kind::dense_optional)
+                 && (!concepts::instance_of<FaceT, geometry::dense_optional_colored_face>)
+    void parse_stream(std::istream &input, HandlerT &&handler){
+        const off_header header = parse_header(input);
+        handler.on_header(header);
 
-            mesh.faces.emplace_back(std::move(face));
+        // Parse vertices.
+        VertexT vertex;
+        for (std::size_t i = 0; i < header.n_vertices; ++i){
+            ignore_comment_or_empty_lines(input);
+
+            parse_vertex(input, vertex);
+            handler.on_vertex(std::as_const(vertex));
 
             ignore_until_newline(input);
         }
 
-        return mesh;
+        // Parse faces.
+        FaceT face;
+        for (std::size_t i = 0; i < header.n_faces; ++i){
+            ignore_comment_or_empty_lines(input);
+
+            face.vertex_indices.clear();
+            parse_face(input, face);
+            handler.on_face(std::as_const(face));
+
+            ignore_until_newline(input);
+        }
     }
-}
\ No newline at end of file
+}
@@ -0,0 +1,360 @@
+//
+// Created by gomkyung2 on 10/18/26.
+//
+
+// Cache-locality reordering of the faces and vertices of a parsed mesh.
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+#include <vector>
+
+#include "geometry/mesh.hpp"
+#include "concepts.hpp"
+
+namespace off_parser{
+    // Vertex ordering strategy used by reorder_vertices.
+    enum class vertex_order{
+        first_use, // Order of first reference in the face list.
+        morton,    // Z-order curve of the vertex positions.
+    };
+
+    struct reorder_options{
+        std::size_t cache_size = 16;
+        vertex_order vertex_ordering = vertex_order::first_use;
+    };
+
+    struct reorder_result{
+        double acmr_before;
+        double acmr_after;
+    };
+
+    namespace details{
+        template <geometry::concepts::mesh_type MeshT>
+        void check_vertex_indices(const MeshT &mesh){
+            for (const auto &face : mesh.faces){
+                for (auto index : face.vertex_indices){
+                    if (static_cast<std::size_t>(index) >= mesh.vertices.size()){
+                        throw std::out_of_range { "Face references a vertex index out of range." };
+                    }
+                }
+            }
+        }
+
+        /**
+         * @brief Spread the lower 10 bits of \p x so that there are two zero bits between each of them.
+         */
+        [[nodiscard]] constexpr std::uint32_t expand_bits_10(std::uint32_t x) noexcept{
+            x &= 0x3FFu;
+            x = (x | (x << 16)) & 0x030000FFu;
+            x = (x | (x << 8)) & 0x0300F00Fu;
+            x = (x | (x << 4)) & 0x030C30C3u;
+            x = (x | (x << 2)) & 0x09249249u;
+            return x;
+        }
+
+        template <typename T>
+        [[nodiscard]] constexpr std::uint32_t quantize_10(T value, T min, T extent) noexcept{
+            if (extent <= T { 0 }){
+                return 0;
+            }
+            const T normalized = (value - min) / extent;
+            return static_cast<std::uint32_t>(std::clamp(normalized, T { 0 }, T { 1 }) * T { 1023 });
+        }
+
+        /**
+         * @brief Move the vertices to their new positions given by \p remap and rewrite every face index accordingly.
+         * @param remap New index of each vertex, which must be a permutation of [0, n_vertices).
+         */
+        template <geometry::concepts::mesh_type MeshT>
+        void apply_vertex_remap(MeshT &mesh, const std::vector<std::size_t> &remap){
+            std::vector<typename MeshT::vertex_type> vertices(mesh.vertices.size());
+            for (std::size_t i = 0; i < mesh.vertices.size(); ++i){
+                vertices[remap[i]] = std::move(mesh.vertices[i]);
+            }
+            mesh.vertices = std::move(vertices);
+
+            if constexpr (geometry::vertex_color_kind_v<typename MeshT::vertex_type> == geometry::color_kind::dense_optional){
+                std::vector<std::size_t> inverse(remap.size());
+                for (std::size_t i = 0; i < remap.size(); ++i){
+                    inverse[remap[i]] = i;
+                }
+
+                decltype(mesh.vertex_colors) vertex_colors;
+                vertex_colors.reserve(mesh.vertex_colors.compact_colors().size());
+                for (auto old_index : inverse){
+                    vertex_colors.push_back(mesh.vertex_colors[old_index]);
+                }
+                mesh.vertex_colors = std::move(vertex_colors);
+            }
+
+            using index_type = typename MeshT::face_type::index_type;
+            for (auto &face : mesh.faces){
+                for (auto &index : face.vertex_indices){
+                    index = static_cast<index_type>(remap[static_cast<std::size_t>(index)]);
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief Compute the average cache miss ratio (ACMR) of \p mesh, simulated with a FIFO post-transform vertex cache.
+     * @param mesh The mesh to be measured.
+     * @param cache_size Number of entries of the simulated vertex cache.
+     * @return Number of cache misses per triangle, where a face with n vertices counts as n - 2 triangles. Lower is
+     * better; 0.5 is the theoretical lower bound for a regular triangle mesh.
+     */
+    template <geometry::concepts::mesh_type MeshT>
+    [[nodiscard]] double compute_acmr(const MeshT &mesh, std::size_t cache_size = 16){
+        details::check_vertex_indices(mesh);
+
+        // A vertex is in cache if it was inserted less than cache_size misses ago.
+        std::vector<std::size_t> cache_time(mesh.vertices.size(), 0);
+        std::size_t time = cache_size + 1;
+
+        std::size_t n_misses = 0, n_triangles = 0;
+        for (const auto &face : mesh.faces){
+            for (auto index : face.vertex_indices){
+                auto &vertex_time = cache_time[static_cast<std::size_t>(index)];
+                if (time - vertex_time > cache_size){
+                    vertex_time = time++;
+                    ++n_misses;
+                }
+            }
+            if (face.vertex_indices.size() >= 3){
+                n_triangles += face.vertex_indices.size() - 2;
+            }
+        }
+
+        return n_triangles == 0 ? 0.0 : static_cast<double>(n_misses) / static_cast<double>(n_triangles);
+    }
+
+    /**
+     * @brief Reorder the faces of \p mesh for post-transform vertex cache reuse, using the Tipsify algorithm (Sander et
+     * al., "Fast Triangle Reordering for Vertex Locality and Reduced Overdraw", 2007).
+     * @param mesh The mesh whose faces will be reordered. Vertices are not touched.
+     * @param cache_size Number of entries of the targeted vertex cache.
+     */
+    template <geometry::concepts::mesh_type MeshT>
+    void reorder_faces(MeshT &mesh, std::size_t cache_size = 16){
+        details::check_vertex_indices(mesh);
+
+        const std::size_t n_vertices = mesh.vertices.size();
+        const std::size_t n_faces = mesh.faces.size();
+
+        // Build vertex-face adjacency in CSR layout. live_count[v] is the number of not-yet-emitted faces using v.
+        std::vector<std::size_t> live_count(n_vertices, 0);
+        for (const auto &face : mesh.faces){
+            for (auto index : face.vertex_indices){
+                ++live_count[static_cast<std::size_t>(index)];
+            }
+        }
+
+        std::vector<std::size_t> adjacency_offsets(n_vertices + 1, 0);
+        std::inclusive_scan(live_count.begin(), live_count.end(), adjacency_offsets.begin() + 1);
+
+        std::vector<std::size_t> adjacency(adjacency_offsets.back());
+        {
+            std::vector<std::size_t> cursors(adjacency_offsets.begin(), adjacency_offsets.end() - 1);
+            for (std::size_t i = 0; i < n_faces; ++i){
+                for (auto index : mesh.faces[i].vertex_indices){
+                    adjacency[cursors[static_cast<std::size_t>(index)]++] = i;
+                }
+            }
+        }
+
+        std::vector<std::size_t> cache_time(n_vertices, 0);
+        std::size_t time = cache_size + 1;
+
+        std::vector<bool> emitted(n_faces, false);
+        std::vector<std::size_t> face_order;
+        face_order.reserve(n_faces);
+
+        std::vector<std::size_t> dead_end_stack, candidates;
+        std::size_t cursor = 0; // Next vertex to be checked when both the candidates and the dead-end stack are exhausted.
+
+        constexpr std::size_t no_vertex = std::numeric_limits<std::size_t>::max();
+        const auto skip_dead_end = [&]() -> std::size_t{
+            while (!dead_end_stack.empty()){
+                const std::size_t vertex = dead_end_stack.back();
+                dead_end_stack.pop_back();
+                if (live_count[vertex] > 0){
+                    return vertex;
+                }
+            }
+            for (; cursor < n_vertices; ++cursor){
+                if (live_count[cursor] > 0){
+                    return cursor++;
+                }
+            }
+            return no_vertex;
+        };
+
+        const auto next_fanning_vertex = [&]() -> std::size_t{
+            std::size_t best_vertex = no_vertex;
+            std::size_t best_priority = 0;
+            for (auto vertex : candidates){
+                if (live_count[vertex] == 0){
+                    continue;
+                }
+
+                // Prefer the oldest vertex that will still be in cache after all of its remaining faces are emitted.
+                std::size_t priority = 0;
+                if (time - cache_time[vertex] + 2 * live_count[vertex] <= cache_size){
+                    priority = time - cache_time[vertex];
+                }
+                if (best_vertex == no_vertex || priority > best_priority){
+                    best_vertex = vertex;
+                    best_priority = priority;
+                }
+            }
+            return best_vertex == no_vertex ? skip_dead_end() : best_vertex;
+        };
+
+        for (std::size_t fanning = skip_dead_end(); fanning != no_vertex; fanning = next_fanning_vertex()){
+            candidates.clear();
+            for (std::size_t i = adjacency_offsets[fanning]; i < adjacency_offsets[fanning + 1]; ++i){
+                const std::size_t face_index = adjacency[i];
+                if (emitted[face_index]){
+                    continue;
+                }
+
+                emitted[face_index] = true;
+                face_order.push_back(face_index);
+
+                for (auto index : mesh.faces[face_index].vertex_indices){
+                    const auto vertex = static_cast<std::size_t>(index);
+                    dead_end_stack.push_back(vertex);
+                    candidates.push_back(vertex);
+                    --live_count[vertex];
+                    if (time - cache_time[vertex] > cache_size){
+                        cache_time[vertex] = time++;
+                    }
+                }
+            }
+        }
+
+        // Faces without any vertex are never reached from the adjacency; keep them at the end.
+        for (std::size_t i = 0; i < n_faces; ++i){
+            if (!emitted[i]){
+                face_order.push_back(i);
+            }
+        }
+
+        std::vector<typename MeshT::face_type> faces;
+        faces.reserve(n_faces);
+        for (auto face_index : face_order){
+            faces.emplace_back(std::move(mesh.faces[face_index]));
+        }
+        mesh.faces = std::move(faces);
+
+        if constexpr (concepts::instance_of<typename MeshT::face_type, geometry::dense_optional_colored_face>){
+            decltype(mesh.face_colors) face_colors;
+            face_colors.reserve(mesh.face_colors.compact_colors().size());
+            for (auto face_index : face_order){
+                face_colors.push_back(mesh.face_colors[face_index]);
+            }
+            mesh.face_colors = std::move(face_colors);
+        }
+    }
+
+    /**
+     * @brief Reorder the vertices of \p mesh and remap the face indices in place.
+     * @param mesh The mesh whose vertices will be reordered.
+     * @param order Ordering strategy. \p vertex_order::first_use should be run after reorder_faces so that vertex
+     * fetches become sequential; unreferenced vertices are moved to the end in their original order.
+     */
+    template <geometry::concepts::mesh_type MeshT>
+    void reorder_vertices(MeshT &mesh, vertex_order order = vertex_order::first_use){
+        details::check_vertex_indices(mesh);
+
+        const std::size_t n_vertices = mesh.vertices.size();
+        constexpr std::size_t unassigned = std::numeric_limits<std::size_t>::max();
+        std::vector<std::size_t> remap(n_vertices, unassigned);
+
+        switch (order){
+            case vertex_order::first_use:{
+                std::size_t next_index = 0;
+                for (const auto &face : mesh.faces){
+                    for (auto index : face.vertex_indices){
+                        auto &new_index = remap[static_cast<std::size_t>(index)];
+                        if (new_index == unassigned){
+                            new_index = next_index++;
+                        }
+                    }
+                }
+                for (auto &new_index : remap){
+                    if (new_index == unassigned){
+                        new_index = next_index++;
+                    }
+                }
+                break;
+            }
+            case vertex_order::morton:{
+                if (n_vertices == 0){
+                    break;
+                }
+
+                using value_type = geometry::vec_value_t<geometry::vertex_position_t<typename MeshT::vertex_type>>;
+                const auto coordinates_of = [](const auto &vertex){
+                    const auto &position = geometry::position_of(vertex);
+                    return std::array<value_type, 3> { geometry::nth<0>(position), geometry::nth<1>(position), geometry::nth<2>(position) };
+                };
+
+                auto min = coordinates_of(mesh.vertices.front()), max = min;
+                for (const auto &vertex : mesh.vertices){
+                    const auto position = coordinates_of(vertex);
+                    for (std::size_t axis = 0; axis < 3; ++axis){
+                        min[axis] = std::min(min[axis], position[axis]);
+                        max[axis] = std::max(max[axis], position[axis]);
+                    }
+                }
+
+                // Quantize every axis with the same scale, so that the curve is not stretched along the shorter axes.
+                const value_type extent = std::max({ max[0] - min[0], max[1] - min[1], max[2] - min[2] });
+
+                std::vector<std::uint32_t> codes(n_vertices);
+                for (std::size_t i = 0; i < n_vertices; ++i){
+                    const auto position = coordinates_of(mesh.vertices[i]);
+                    codes[i] = (details::expand_bits_10(details::quantize_10(position[0], min[0], extent)) << 2)
+                             | (details::expand_bits_10(details::quantize_10(position[1], min[1], extent)) << 1)
+                             |  details::expand_bits_10(details::quantize_10(position[2], min[2], extent));
+                }
+
+                std::vector<std::size_t> sorted(n_vertices);
+                std::iota(sorted.begin(), sorted.end(), std::size_t { 0 });
+                std::ranges::stable_sort(sorted, {}, [&](std::size_t i) { return codes[i]; });
+
+                for (std::size_t i = 0; i < n_vertices; ++i){
+                    remap[sorted[i]] = i;
+                }
+                break;
+            }
+        }
+
+        details::apply_vertex_remap(mesh, remap);
+    }
+
+    /**
+     * @brief Post-parse locality optimization: reorder faces for vertex cache reuse, and then reorder vertices.
+     * @param mesh The mesh to be optimized in place.
+     * @param options Cache size and vertex ordering strategy.
+     * @return ACMR of \p mesh before and after the optimization, simulated with \p options.cache_size entries.
+     */
+    template <geometry::concepts::mesh_type MeshT>
+    reorder_result optimize_locality(MeshT &mesh, const reorder_options &options = {}){
+        reorder_result result;
+        result.acmr_before = compute_acmr(mesh, options.cache_size);
+
+        reorder_faces(mesh, options.cache_size);
+        reorder_vertices(mesh, options.vertex_ordering);
+
+        result.acmr_after = compute_acmr(mesh, options.cache_size);
+        return result;
+    }
+}
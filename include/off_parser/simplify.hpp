@@ -0,0 +1,543 @@
+//
+// Created by gomkyung2 on 10/18/26.
+//
+
+// Mesh simplification by quadric error metrics (Garland and Heckbert, 1997), for generating levels of detail at load
+// time. Faces are fan-triangulated, and vertex colors are interpolated along the collapsed edges.
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "geometry/mesh.hpp"
+#include "concepts.hpp"
+#include "details/parallel.hpp"
+#include "details/vec3_math.hpp"
+
+namespace off_parser{
+    struct simplify_options{
+        double max_error = std::numeric_limits<double>::infinity(); // Edges with larger quadric error are never collapsed.
+        double boundary_weight = 1000.0; // Weight of the constraint planes keeping boundary edges in place.
+        std::size_t max_passes = 256;
+    };
+
+    namespace details{
+        using vec3d = geometry::vec3<double>;
+
+        // Symmetric 4x4 matrix of the plane equations' outer products.
+        struct quadric{
+            double xx = 0, xy = 0, xz = 0, xw = 0, yy = 0, yz = 0, yw = 0, zz = 0, zw = 0, ww = 0;
+
+            // Quadric of plane n.p + d = 0, scaled by weight.
+            [[nodiscard]] static constexpr quadric from_plane(const vec3d &n, double d, double weight) noexcept{
+                return {
+                    weight * n.x * n.x, weight * n.x * n.y, weight * n.x * n.z, weight * n.x * d,
+                    weight * n.y * n.y, weight * n.y * n.z, weight * n.y * d,
+                    weight * n.z * n.z, weight * n.z * d,
+                    weight * d * d
+                };
+            }
+
+            constexpr quadric &operator+=(const quadric &q) noexcept{
+                xx += q.xx; xy += q.xy; xz += q.xz; xw += q.xw; yy += q.yy;
+                yz += q.yz; yw += q.yw; zz += q.zz; zw += q.zw; ww += q.ww;
+                return *this;
+            }
+
+            [[nodiscard]] constexpr double error(const vec3d &p) const noexcept{
+                return p.x * (xx * p.x + 2 * (xy * p.y + xz * p.z + xw))
+                     + p.y * (yy * p.y + 2 * (yz * p.z + yw))
+                     + p.z * (zz * p.z + 2 * zw)
+                     + ww;
+            }
+
+            // Point minimizing the error, if the 3x3 system is well-conditioned.
+            [[nodiscard]] std::optional<vec3d> minimizer() const noexcept{
+                const double det = xx * (yy * zz - yz * yz) - xy * (xy * zz - yz * xz) + xz * (xy * yz - yy * xz);
+                const double scale = std::max({ std::abs(xx), std::abs(yy), std::abs(zz) });
+                if (std::abs(det) <= 1e-12 * scale * scale * scale){
+                    return std::nullopt;
+                }
+
+                // Cramer's rule for A p = -b.
+                const double bx = -xw, by = -yw, bz = -zw;
+                const double inv = 1.0 / det;
+                return vec3d {
+                    inv * (bx * (yy * zz - yz * yz) - xy * (by * zz - yz * bz) + xz * (by * yz - yy * bz)),
+                    inv * (xx * (by * zz - bz * yz) - bx * (xy * zz - yz * xz) + xz * (xy * bz - by * xz)),
+                    inv * (xx * (yy * bz - yz * by) - xy * (xy * bz - by * xz) + bx * (xy * yz - yy * xz)),
+                };
+            }
+        };
+
+        template <geometry::concepts::vec_type VecT>
+        [[nodiscard]] VecT lerp_vec(const VecT &a, const VecT &b, double t) noexcept{
+            VecT result;
+            [&]<std::size_t... Is>(std::index_sequence<Is...>){
+                ((geometry::nth<Is>(result) = static_cast<geometry::vec_value_t<VecT>>(
+                    (1.0 - t) * static_cast<double>(geometry::nth<Is>(a)) + t * static_cast<double>(geometry::nth<Is>(b)))), ...);
+            }(std::make_index_sequence<geometry::vec_size_v<VecT>>{});
+            return result;
+        }
+
+        template <typename ColorT>
+        [[nodiscard]] std::optional<ColorT> lerp_optional_color(const std::optional<ColorT> &a, const std::optional<ColorT> &b, double t) noexcept{
+            if (a && b){
+                return lerp_vec(*a, *b, t);
+            }
+            return a ? a : b;
+        }
+
+        // Colors of color_kind::dense_optional vertices while simplifying, since they are not stored in the vertex. Empty
+        // for the other vertex types.
+        template <typename VertexT>
+        struct dense_vertex_colors {};
+
+        template <typename VertexT>
+            requires (geometry::vertex_color_kind_v<VertexT> == geometry::color_kind::dense_optional)
+        struct dense_vertex_colors<VertexT>{
+            std::vector<std::optional<typename geometry::vertex_traits<VertexT>::color_type>> colors;
+        };
+
+        template <geometry::concepts::mesh_type MeshT>
+            requires geometry::concepts::vertex_color_gettable<typename MeshT::vertex_type>
+        class simplifier{
+        public:
+            simplifier(const MeshT &mesh, const simplify_options &options) : mesh { mesh }, options { options } {
+                const std::size_t n_vertices = mesh.vertices.size();
+                positions.resize(n_vertices);
+                for (std::size_t i = 0; i < n_vertices; ++i){
+                    const auto &p = geometry::position_of(mesh.vertices[i]);
+                    positions[i] = {
+                        static_cast<double>(geometry::nth<0>(p)),
+                        static_cast<double>(geometry::nth<1>(p)),
+                        static_cast<double>(geometry::nth<2>(p))
+                    };
+                }
+                vertices = mesh.vertices;
+                if constexpr (geometry::vertex_color_kind_v<typename MeshT::vertex_type> == geometry::color_kind::dense_optional){
+                    vertex_colors.colors.resize(n_vertices);
+                    for (std::size_t i = 0; i < n_vertices; ++i){
+                        vertex_colors.colors[i] = mesh.vertex_colors[i];
+                    }
+                }
+
+                // Fan-triangulate the faces.
+                for (std::size_t i = 0; i < mesh.faces.size(); ++i){
+                    const auto &indices = mesh.faces[i].vertex_indices;
+                    for (auto index : indices){
+                        if (static_cast<std::size_t>(index) >= n_vertices){
+                            throw std::out_of_range { "Face references a vertex index out of range." };
+                        }
+                    }
+                    for (std::size_t j = 2; j < indices.size(); ++j){
+                        const std::array triangle {
+                            static_cast<std::uint32_t>(indices[0]),
+                            static_cast<std::uint32_t>(indices[j - 1]),
+                            static_cast<std::uint32_t>(indices[j])
+                        };
+                        if (triangle[0] != triangle[1] && triangle[1] != triangle[2] && triangle[2] != triangle[0]){
+                            triangles.push_back(triangle);
+                            source_faces.push_back(i);
+                        }
+                    }
+                }
+
+                // Accumulate the area-weighted plane quadrics of the incident triangles.
+                quadrics.resize(n_vertices);
+                for (const auto &triangle : triangles){
+                    const vec3d n = cross(positions[triangle[1]] - positions[triangle[0]], positions[triangle[2]] - positions[triangle[0]]);
+                    const double length = std::sqrt(dot(n, n));
+                    if (length == 0.0){
+                        continue;
+                    }
+
+                    const vec3d unit { n.x / length, n.y / length, n.z / length };
+                    const quadric q = quadric::from_plane(unit, -dot(unit, positions[triangle[0]]), length / 2);
+                    for (auto vertex : triangle){
+                        quadrics[vertex] += q;
+                    }
+                }
+                add_boundary_constraints();
+            }
+
+            [[nodiscard]] std::size_t n_triangles() const noexcept{
+                return triangles.size();
+            }
+
+            /**
+             * @brief Collapse edges until the number of triangles is at most \p target, or no more edge can be collapsed.
+             */
+            void simplify_to(std::size_t target){
+                for (std::size_t pass = 0; pass < options.max_passes && triangles.size() > target; ++pass){
+                    if (!run_pass(target)){
+                        break;
+                    }
+                }
+            }
+
+            // Current state as a mesh, without unreferenced vertices.
+            [[nodiscard]] MeshT to_mesh() const{
+                MeshT result;
+                result.n_edges = 0;
+
+                constexpr std::uint32_t unused = std::numeric_limits<std::uint32_t>::max();
+                std::vector<std::uint32_t> new_indices(vertices.size(), unused);
+                for (const auto &triangle : triangles){
+                    for (auto vertex : triangle){
+                        if (new_indices[vertex] == unused){
+                            new_indices[vertex] = static_cast<std::uint32_t>(result.vertices.size());
+
+                            auto v = vertices[vertex];
+                            using value_type = geometry::vec_value_t<geometry::vertex_position_t<typename MeshT::vertex_type>>;
+                            auto &p = geometry::position_of(v);
+                            geometry::nth<0>(p) = static_cast<value_type>(positions[vertex].x);
+                            geometry::nth<1>(p) = static_cast<value_type>(positions[vertex].y);
+                            geometry::nth<2>(p) = static_cast<value_type>(positions[vertex].z);
+                            result.vertices.push_back(v);
+                            if constexpr (geometry::vertex_color_kind_v<typename MeshT::vertex_type> == geometry::color_kind::dense_optional){
+                                result.vertex_colors.push_back(vertex_colors.colors[vertex]);
+                            }
+                        }
+                    }
+                }
+
+                using index_type = typename MeshT::face_type::index_type;
+                result.faces.reserve(triangles.size());
+                for (std::size_t i = 0; i < triangles.size(); ++i){
+                    auto face = mesh.faces[source_faces[i]];
+                    face.vertex_indices.assign({
+                        static_cast<index_type>(new_indices[triangles[i][0]]),
+                        static_cast<index_type>(new_indices[triangles[i][1]]),
+                        static_cast<index_type>(new_indices[triangles[i][2]])
+                    });
+                    result.faces.push_back(std::move(face));
+                    if constexpr (concepts::instance_of<typename MeshT::face_type, geometry::dense_optional_colored_face>){
+                        result.face_colors.push_back(mesh.face_colors[source_faces[i]]);
+                    }
+                }
+                return result;
+            }
+
+        private:
+            struct candidate{
+                double cost;
+                std::uint32_t a, b;
+                vec3d position;
+                double t; // Parameter of position projected onto the edge, for attribute interpolation.
+            };
+
+            const MeshT &mesh;
+            const simplify_options &options;
+
+            std::vector<vec3d> positions;
+            std::vector<typename MeshT::vertex_type> vertices; // Carries the vertex attributes other than position.
+            std::vector<quadric> quadrics;
+            std::vector<std::array<std::uint32_t, 3>> triangles;
+            std::vector<std::size_t> source_faces; // Input face of each triangle.
+
+            [[no_unique_address]] dense_vertex_colors<typename MeshT::vertex_type> vertex_colors;
+
+            // Vertex to incident triangles, in CSR layout.
+            std::vector<std::size_t> incidence_offsets;
+            std::vector<std::uint32_t> incidence;
+
+            [[nodiscard]] std::span<const std::uint32_t> incident_triangles(std::uint32_t vertex) const noexcept{
+                return std::span { incidence }.subspan(incidence_offsets[vertex], incidence_offsets[vertex + 1] - incidence_offsets[vertex]);
+            }
+
+            void build_incidence(){
+                incidence_offsets.assign(positions.size() + 1, 0);
+                for (const auto &triangle : triangles){
+                    for (auto vertex : triangle){
+                        ++incidence_offsets[vertex + 1];
+                    }
+                }
+                std::partial_sum(incidence_offsets.begin(), incidence_offsets.end(), incidence_offsets.begin());
+
+                incidence.resize(incidence_offsets.back());
+                std::vector<std::size_t> cursors(incidence_offsets.begin(), incidence_offsets.end() - 1);
+                for (std::size_t i = 0; i < triangles.size(); ++i){
+                    for (auto vertex : triangles[i]){
+                        incidence[cursors[vertex]++] = static_cast<std::uint32_t>(i);
+                    }
+                }
+            }
+
+            // Unique undirected edges as (min << 32 | max), and the number of triangles sharing each.
+            [[nodiscard]] std::vector<std::pair<std::uint64_t, std::uint32_t>> collect_edges() const{
+                std::vector<std::uint64_t> keys;
+                keys.reserve(triangles.size() * 3);
+                for (const auto &triangle : triangles){
+                    for (std::size_t i = 0; i < 3; ++i){
+                        const std::uint64_t a = triangle[i], b = triangle[(i + 1) % 3];
+                        keys.push_back(std::min(a, b) << 32 | std::max(a, b));
+                    }
+                }
+                std::ranges::sort(keys);
+
+                std::vector<std::pair<std::uint64_t, std::uint32_t>> edges;
+                for (std::size_t i = 0; i < keys.size();){
+                    std::size_t j = i;
+                    while (j < keys.size() && keys[j] == keys[i]){
+                        ++j;
+                    }
+                    edges.emplace_back(keys[i], static_cast<std::uint32_t>(j - i));
+                    i = j;
+                }
+                return edges;
+            }
+
+            // Constrain the boundary edges with planes perpendicular to their triangle.
+            void add_boundary_constraints(){
+                build_incidence();
+                for (const auto &[key, n_shared] : collect_edges()){
+                    if (n_shared != 1){
+                        continue;
+                    }
+
+                    const auto a = static_cast<std::uint32_t>(key >> 32), b = static_cast<std::uint32_t>(key);
+                    for (auto t : incident_triangles(a)){
+                        const auto &triangle = triangles[t];
+                        if (std::ranges::find(triangle, b) == triangle.end()){
+                            continue;
+                        }
+
+                        const vec3d face_normal = cross(positions[triangle[1]] - positions[triangle[0]], positions[triangle[2]] - positions[triangle[0]]);
+                        const vec3d edge = positions[b] - positions[a];
+                        const vec3d n = cross(edge, face_normal);
+                        const double length = std::sqrt(dot(n, n));
+                        if (length == 0.0){
+                            break;
+                        }
+
+                        const vec3d unit { n.x / length, n.y / length, n.z / length };
+                        const quadric q = quadric::from_plane(unit, -dot(unit, positions[a]), options.boundary_weight * dot(edge, edge));
+                        quadrics[a] += q;
+                        quadrics[b] += q;
+                        break;
+                    }
+                }
+            }
+
+            [[nodiscard]] candidate evaluate(std::uint32_t a, std::uint32_t b) const noexcept{
+                quadric q = quadrics[a];
+                q += quadrics[b];
+
+                const vec3d &pa = positions[a], &pb = positions[b];
+                const vec3d edge = pb - pa;
+                const double edge_length2 = dot(edge, edge);
+                const auto parameter_of = [&](const vec3d &p){
+                    return edge_length2 == 0.0 ? 0.5 : std::clamp(dot(p - pa, edge) / edge_length2, 0.0, 1.0);
+                };
+
+                candidate best { std::numeric_limits<double>::infinity(), a, b, pa, 0.0 };
+                const auto consider = [&](const vec3d &p){
+                    if (const double cost = q.error(p); cost < best.cost){
+                        best = { cost, a, b, p, parameter_of(p) };
+                    }
+                };
+
+                if (auto optimal = q.minimizer()){
+                    consider(*optimal);
+                }
+                consider(pa);
+                consider(pb);
+                consider({ (pa.x + pb.x) / 2, (pa.y + pb.y) / 2, (pa.z + pb.z) / 2 });
+                best.cost = std::max(best.cost, 0.0);
+                return best;
+            }
+
+            // Collect the vertices adjacent to vertex, excluding itself, into neighbors (sorted and unique).
+            void gather_neighbors(std::uint32_t vertex, std::vector<std::uint32_t> &neighbors) const{
+                neighbors.clear();
+                for (auto t : incident_triangles(vertex)){
+                    for (auto other : triangles[t]){
+                        if (other != vertex){
+                            neighbors.push_back(other);
+                        }
+                    }
+                }
+                std::ranges::sort(neighbors);
+                neighbors.erase(std::unique(neighbors.begin(), neighbors.end()), neighbors.end());
+            }
+
+            // Whether moving a and b to position flips any triangle that survives the collapse.
+            [[nodiscard]] bool flips(std::uint32_t a, std::uint32_t b, const vec3d &position) const noexcept{
+                for (auto vertex : { a, b }){
+                    for (auto t : incident_triangles(vertex)){
+                        const auto &triangle = triangles[t];
+                        if (std::ranges::find(triangle, a) != triangle.end() && std::ranges::find(triangle, b) != triangle.end()){
+                            continue; // Removed by the collapse.
+                        }
+
+                        std::array<vec3d, 3> before, after;
+                        for (std::size_t i = 0; i < 3; ++i){
+                            before[i] = positions[triangle[i]];
+                            after[i] = (triangle[i] == a || triangle[i] == b) ? position : before[i];
+                        }
+                        const vec3d n_before = cross(before[1] - before[0], before[2] - before[0]);
+                        const vec3d n_after = cross(after[1] - after[0], after[2] - after[0]);
+                        // A triangle that is already degenerate has no orientation to lose.
+                        if (dot(n_before, n_before) > 0.0 && dot(n_before, n_after) <= 0.0){
+                            return true;
+                        }
+                    }
+                }
+                return false;
+            }
+
+            /**
+             * @brief Run a collapse pass: evaluate every edge, and greedily collapse the cheapest ones whose 1-rings do
+             * not overlap, rejecting those that would break the link condition or flip a face.
+             * @return Whether any edge was collapsed.
+             */
+            bool run_pass(std::size_t target){
+                build_incidence();
+                const auto edges = collect_edges();
+
+                // Evaluate every manifold edge concurrently. Non-manifold edges are marked with a NaN cost (which
+                // evaluate never returns) and dropped before sorting.
+                std::vector<candidate> candidates(edges.size());
+                parallel_for(edges.size(), 4096, [&](std::size_t i){
+                    const auto [key, n_shared] = edges[i];
+                    if (n_shared > 2){
+                        candidates[i].cost = std::numeric_limits<double>::quiet_NaN();
+                        return;
+                    }
+                    candidates[i] = evaluate(static_cast<std::uint32_t>(key >> 32), static_cast<std::uint32_t>(key));
+                });
+                std::erase_if(candidates, [](const candidate &c){ return std::isnan(c.cost); });
+                std::ranges::sort(candidates, {}, &candidate::cost);
+
+                std::vector<bool> locked(positions.size(), false);
+                std::vector<std::uint32_t> remap(positions.size());
+                std::iota(remap.begin(), remap.end(), std::uint32_t { 0 });
+
+                std::vector<std::uint32_t> neighbors_a, neighbors_b;
+                std::size_t n_remaining = triangles.size();
+                bool collapsed = false;
+                for (const auto &c : candidates){
+                    if (n_remaining <= target || !std::isfinite(c.cost) || c.cost > options.max_error){
+                        break;
+                    }
+                    if (locked[c.a] || locked[c.b]){
+                        continue;
+                    }
+
+                    // Link condition: the common neighbors of a and b must be exactly the opposite vertices of the
+                    // triangles sharing the edge.
+                    gather_neighbors(c.a, neighbors_a);
+                    gather_neighbors(c.b, neighbors_b);
+                    std::size_t n_common = 0, n_shared = 0;
+                    for (auto t : incident_triangles(c.a)){
+                        n_shared += std::ranges::find(triangles[t], c.b) != triangles[t].end();
+                    }
+                    for (std::size_t i = 0, j = 0; i < neighbors_a.size() && j < neighbors_b.size();){
+                        if (neighbors_a[i] < neighbors_b[j]) ++i;
+                        else if (neighbors_b[j] < neighbors_a[i]) ++j;
+                        else { ++n_common; ++i; ++j; }
+                    }
+                    // Also keep at least three vertices around the merged vertex, so that a closed component does not
+                    // collapse into a doubled triangle.
+                    const bool too_small = neighbors_a.size() + neighbors_b.size() < n_common + 2 + 3;
+                    if (n_common != n_shared || too_small || flips(c.a, c.b, c.position)){
+                        continue;
+                    }
+
+                    // Collapse b into a.
+                    positions[c.a] = c.position;
+                    quadrics[c.a] += quadrics[c.b];
+                    using vertex_traits = geometry::vertex_traits<typename MeshT::vertex_type>;
+                    if constexpr (vertex_traits::color == geometry::color_kind::required){
+                        vertex_traits::set_color(vertices[c.a], lerp_vec<typename vertex_traits::color_type>(
+                            vertex_traits::get_color(vertices[c.a]), vertex_traits::get_color(vertices[c.b]), c.t));
+                    }
+                    else if constexpr (vertex_traits::color == geometry::color_kind::optional){
+                        vertex_traits::set_color(vertices[c.a], lerp_optional_color<typename vertex_traits::color_type>(
+                            vertex_traits::get_color(vertices[c.a]), vertex_traits::get_color(vertices[c.b]), c.t));
+                    }
+                    else if constexpr (vertex_traits::color == geometry::color_kind::dense_optional){
+                        vertex_colors.colors[c.a] = lerp_optional_color(vertex_colors.colors[c.a], vertex_colors.colors[c.b], c.t);
+                    }
+                    remap[c.b] = c.a;
+
+                    // Lock the 1-ring, so that the other collapses of this pass do not touch these triangles.
+                    locked[c.a] = locked[c.b] = true;
+                    for (auto neighbor : neighbors_a) locked[neighbor] = true;
+                    for (auto neighbor : neighbors_b) locked[neighbor] = true;
+
+                    n_remaining -= n_shared;
+                    collapsed = true;
+                }
+
+                if (!collapsed){
+                    return false;
+                }
+
+                // Apply the collapses and drop the degenerate triangles.
+                std::size_t n_kept = 0;
+                for (std::size_t i = 0; i < triangles.size(); ++i){
+                    auto triangle = triangles[i];
+                    for (auto &vertex : triangle){
+                        vertex = remap[vertex];
+                    }
+                    if (triangle[0] != triangle[1] && triangle[1] != triangle[2] && triangle[2] != triangle[0]){
+                        triangles[n_kept] = triangle;
+                        source_faces[n_kept] = source_faces[i];
+                        ++n_kept;
+                    }
+                }
+                triangles.resize(n_kept);
+                source_faces.resize(n_kept);
+                return true;
+            }
+        };
+    }
+
+    /**
+     * @brief Generate levels of detail of \p mesh by quadric error edge collapse.
+     * @tparam MeshT Mesh type. A vertex type storing its color must provide vertex_traits::get_color, since the colors
+     * are interpolated.
+     * @param mesh Source mesh.
+     * @param target_face_counts Target number of (triangle) faces of each level. A level may have more faces if the
+     * error limit is reached or no more edge can be collapsed without breaking the topology.
+     * @param options Simplification options.
+     * @return Simplified meshes, in the same order as \p target_face_counts. Each level is simplified from the previous
+     * finer level, so generating a pyramid costs about the same as generating the coarsest level.
+     */
+    template <geometry::concepts::mesh_type MeshT>
+        requires geometry::concepts::vertex_color_gettable<typename MeshT::vertex_type>
+    [[nodiscard]] std::vector<MeshT> build_lod_pyramid(const MeshT &mesh, std::span<const std::size_t> target_face_counts, const simplify_options &options = {}){
+        std::vector<std::size_t> order(target_face_counts.size());
+        std::iota(order.begin(), order.end(), std::size_t { 0 });
+        std::ranges::sort(order, std::ranges::greater{}, [&](std::size_t i) { return target_face_counts[i]; });
+
+        details::simplifier<MeshT> simplifier { mesh, options };
+        std::vector<MeshT> result(target_face_counts.size());
+        for (auto i : order){
+            simplifier.simplify_to(target_face_counts[i]);
+            result[i] = simplifier.to_mesh();
+        }
+        return result;
+    }
+
+    /**
+     * @brief Simplify \p mesh to at most \p target_face_count (triangle) faces, if possible.
+     */
+    template <geometry::concepts::mesh_type MeshT>
+        requires geometry::concepts::vertex_color_gettable<typename MeshT::vertex_type>
+    [[nodiscard]] MeshT simplify(const MeshT &mesh, std::size_t target_face_count, const simplify_options &options = {}){
+        return std::move(build_lod_pyramid(mesh, std::span { &target_face_count, 1 }, options).front());
+    }
+}
@@ -0,0 +1,548 @@
+//
+// Created by gomkyung2 on 10/18/26.
+//
+
+// constexpr OFF parser over std::string_view, for small meshes embedded in the binary (see example/off_static.cpp).
+// Malformed input throws std::invalid_argument, which is a compile error in constant evaluation.
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <compare>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <stdexcept>
+#include <string_view>
+#include <utility>
+
+#include "geometry/static_mesh.hpp"
+#include "concepts.hpp"
+
+namespace off_parser{
+    namespace details{
+        // Unsigned integer of at most Limbs * 32 bits, usable in constant evaluation.
+        template <std::size_t Limbs>
+        class static_bigint{
+        public:
+            [[nodiscard]] constexpr bool is_zero() const noexcept{
+                return size == 0;
+            }
+
+            [[nodiscard]] constexpr std::size_t bit_width() const noexcept{
+                return size == 0 ? 0 : 32 * (size - 1) + static_cast<std::size_t>(std::bit_width(limbs[size - 1]));
+            }
+
+            [[nodiscard]] constexpr bool bit(std::size_t i) const noexcept{
+                return i / 32 < size && ((limbs[i / 32] >> (i % 32)) & 1);
+            }
+
+            // Whether any bit below \p i is set.
+            [[nodiscard]] constexpr bool any_bit_below(std::size_t i) const noexcept{
+                for (std::size_t limb = 0; limb < size && 32 * limb < i; ++limb){
+                    const std::size_t n_bits = std::min<std::size_t>(i - 32 * limb, 32);
+                    const std::uint32_t mask = n_bits == 32 ? ~std::uint32_t { 0 } : (std::uint32_t { 1 } << n_bits) - 1;
+                    if (limbs[limb] & mask){
+                        return true;
+                    }
+                }
+                return false;
+            }
+
+            constexpr void set_bit(std::size_t i){
+                while (size <= i / 32){
+                    push_limb(0);
+                }
+                limbs[i / 32] |= std::uint32_t { 1 } << (i % 32);
+            }
+
+            // *this = *this * multiplier + addend.
+            constexpr void multiply_add(std::uint32_t multiplier, std::uint32_t addend){
+                std::uint64_t carry = addend;
+                for (std::size_t i = 0; i < size; ++i){
+                    carry += static_cast<std::uint64_t>(limbs[i]) * multiplier;
+                    limbs[i] = static_cast<std::uint32_t>(carry);
+                    carry >>= 32;
+                }
+                if (carry != 0){
+                    push_limb(static_cast<std::uint32_t>(carry));
+                }
+            }
+
+            // *this *= 10^n.
+            constexpr void multiply_pow10(std::size_t n){
+                for (; n >= 9; n -= 9){
+                    multiply_add(1'000'000'000, 0);
+                }
+                constexpr std::array<std::uint32_t, 9> pow10s { 1, 10, 100, 1'000, 10'000, 100'000, 1'000'000, 10'000'000, 100'000'000 };
+                multiply_add(pow10s[n], 0);
+            }
+
+            constexpr void shift_left(std::size_t n){
+                if (size == 0){
+                    return;
+                }
+
+                const std::size_t limb_shift = n / 32, bit_shift = n % 32;
+                for (std::size_t i = 0; i < limb_shift + 1; ++i){
+                    push_limb(0);
+                }
+                for (std::size_t i = size; i-- > 0;){
+                    std::uint32_t limb = 0;
+                    if (i >= limb_shift){
+                        limb = limbs[i - limb_shift] << bit_shift;
+                        if (bit_shift != 0 && i > limb_shift){
+                            limb |= limbs[i - limb_shift - 1] >> (32 - bit_shift);
+                        }
+                    }
+                    limbs[i] = limb;
+                }
+                trim();
+            }
+
+            constexpr void shift_right_1() noexcept{
+                for (std::size_t i = 0; i < size; ++i){
+                    limbs[i] = (limbs[i] >> 1) | (i + 1 < size ? limbs[i + 1] << 31 : 0);
+                }
+                trim();
+            }
+
+            // *this -= rhs, where rhs <= *this.
+            constexpr void subtract(const static_bigint &rhs) noexcept{
+                std::int64_t borrow = 0;
+                for (std::size_t i = 0; i < size; ++i){
+                    std::int64_t difference = static_cast<std::int64_t>(limbs[i]) - (i < rhs.size ? rhs.limbs[i] : 0) - borrow;
+                    borrow = difference < 0;
+                    limbs[i] = static_cast<std::uint32_t>(difference + (borrow << 32));
+                }
+                trim();
+            }
+
+            [[nodiscard]] constexpr std::strong_ordering operator<=>(const static_bigint &rhs) const noexcept{
+                if (size != rhs.size){
+                    return size <=> rhs.size;
+                }
+                for (std::size_t i = size; i-- > 0;){
+                    if (limbs[i] != rhs.limbs[i]){
+                        return limbs[i] <=> rhs.limbs[i];
+                    }
+                }
+                return std::strong_ordering::equal;
+            }
+
+        private:
+            std::array<std::uint32_t, Limbs> limbs {};
+            std::size_t size = 0; // Number of limbs in use. The most significant one is nonzero.
+
+            constexpr void push_limb(std::uint32_t limb){
+                if (size == Limbs){
+                    throw std::invalid_argument { "Floating point number is too long." };
+                }
+                limbs[size++] = limb;
+            }
+
+            constexpr void trim() noexcept{
+                while (size != 0 && limbs[size - 1] == 0){
+                    --size;
+                }
+            }
+        };
+
+        // Significant decimal digits kept by read_floating, enough for rounding any float or double exactly.
+        constexpr int max_significant_digits = 800;
+
+        // Number of limbs of the integers used by read_floating<T>, after its range check.
+        template <std::floating_point T>
+        [[nodiscard]] consteval std::size_t static_bigint_limbs() noexcept{
+            using limits = std::numeric_limits<T>;
+            const std::size_t max_decimal_digits = std::max(
+                limits::max_exponent10 + 2,
+                -limits::min_exponent10 + limits::max_digits10 + max_significant_digits + 4);
+            return (max_decimal_digits * 3322 / 1000 + 2 * limits::digits + 64) / 32 + 1;
+        }
+
+        // 2^n, computed exactly.
+        template <std::floating_point T>
+        [[nodiscard]] constexpr T pow2(int n) noexcept{
+            T result = 1, base = n < 0 ? T { 0.5 } : T { 2 };
+            for (unsigned int k = static_cast<unsigned int>(n < 0 ? -n : n); k != 0; k >>= 1){
+                if (k & 1){
+                    result *= base;
+                }
+                if (k > 1){
+                    base *= base;
+                }
+            }
+            return result;
+        }
+
+        /**
+         * @brief Round \p significand * 10^\p exponent to nearest (ties to even) \p T.
+         * @throw std::invalid_argument If the result overflows, or underflows to zero.
+         */
+        template <std::floating_point T, std::size_t Limbs>
+        [[nodiscard]] constexpr T round_to_floating(static_bigint<Limbs> numerator, int exponent){
+            using limits = std::numeric_limits<T>;
+            constexpr int precision = limits::digits, min_exponent = limits::min_exponent - 1, max_exponent = limits::max_exponent - 1;
+
+            static_bigint<Limbs> denominator;
+            denominator.multiply_add(1, 1);
+            (exponent < 0 ? denominator : numerator).multiply_pow10(static_cast<std::size_t>(exponent < 0 ? -exponent : exponent));
+
+            // Scale so that the quotient numerator / denominator has precision + 3 or precision + 4 bits.
+            const int shift = precision + 3 - (static_cast<int>(numerator.bit_width()) - static_cast<int>(denominator.bit_width()));
+            if (shift > 0){
+                numerator.shift_left(static_cast<std::size_t>(shift));
+            }
+            else{
+                denominator.shift_left(static_cast<std::size_t>(-shift));
+            }
+
+            // Binary long division.
+            static_bigint<Limbs> quotient;
+            denominator.shift_left(precision + 4);
+            for (std::size_t i = precision + 4; i-- > 0;){
+                denominator.shift_right_1();
+                if (numerator >= denominator){
+                    numerator.subtract(denominator);
+                    quotient.set_bit(i);
+                }
+            }
+
+            // The value is in [2^leading_exponent, 2^(leading_exponent + 1)). Subnormal results have fewer bits.
+            const int quotient_width = static_cast<int>(quotient.bit_width());
+            const int leading_exponent = quotient_width - 1 - shift;
+            const int n_kept_bits = leading_exponent < min_exponent ? precision - (min_exponent - leading_exponent) : precision;
+            const int n_dropped_bits = quotient_width - n_kept_bits; // Always positive.
+
+            T mantissa = 0;
+            bool odd = false;
+            for (int i = quotient_width - 1; i >= n_dropped_bits; --i){
+                odd = quotient.bit(static_cast<std::size_t>(i));
+                mantissa = mantissa * 2 + (odd ? 1 : 0);
+            }
+            const bool half = quotient.bit(static_cast<std::size_t>(n_dropped_bits - 1));
+            const bool sticky = quotient.any_bit_below(static_cast<std::size_t>(n_dropped_bits - 1)) || !numerator.is_zero();
+            if (half && (sticky || odd)){
+                mantissa += 1;
+            }
+
+            if (mantissa == 0 || leading_exponent > max_exponent ||
+                (leading_exponent == max_exponent && mantissa == pow2<T>(precision)))
+            {
+                throw std::invalid_argument { "Floating point number is out of range." };
+            }
+            return mantissa * pow2<T>(n_dropped_bits - shift);
+        }
+
+        class static_reader{
+        public:
+            constexpr explicit static_reader(std::string_view data) noexcept : data { data } { }
+
+            [[nodiscard]] constexpr bool eof() const noexcept{
+                return position == data.size();
+            }
+
+            constexpr void ignore_until_newline() noexcept{
+                while (!eof() && data[position++] != '\n');
+            }
+
+            constexpr void ignore_comment_or_empty_lines() noexcept{
+                while (!eof()){
+                    skip_spaces();
+                    if (eof()){
+                        return;
+                    }
+
+                    switch (data[position]){
+                        case '\n':
+                            ++position;
+                            break;
+                        case '#':
+                            ignore_until_newline();
+                            break;
+                        default:
+                            return;
+                    }
+                }
+            }
+
+            // Whether there is no more token in the current line.
+            [[nodiscard]] constexpr bool at_line_end() noexcept{
+                skip_spaces();
+                return eof() || data[position] == '\n';
+            }
+
+            template <std::unsigned_integral T>
+            [[nodiscard]] constexpr T read_unsigned(){
+                skip_spaces();
+                if (eof() || !is_digit(data[position])){
+                    throw std::invalid_argument { "Expected an unsigned integer." };
+                }
+
+                T result = 0;
+                for (; !eof() && is_digit(data[position]); ++position){
+                    const T digit = static_cast<T>(data[position] - '0');
+                    if (result > (std::numeric_limits<T>::max() - digit) / 10){
+                        throw std::invalid_argument { "Integer is out of range." };
+                    }
+                    result = static_cast<T>(result * 10 + digit);
+                }
+                return result;
+            }
+
+            /**
+             * @brief Read a floating point number, correctly rounded like std::from_chars (and therefore parse).
+             * @throw std::invalid_argument If the number is malformed, or out of the range of \p T.
+             */
+            template <std::floating_point T>
+            [[nodiscard]] constexpr T read_floating(){
+                skip_spaces();
+
+                bool negative = false;
+                if (!eof() && (data[position] == '-' || data[position] == '+')){
+                    negative = data[position++] == '-';
+                }
+
+                // The value is significand * 10^exponent. Digits past max_significant_digits only matter in being nonzero.
+                static_bigint<static_bigint_limbs<T>()> significand;
+                int n_digits = 0, exponent = 0;
+                bool has_digit = false, truncated = false;
+                const auto read_digits = [&](bool fractional){
+                    for (; !eof() && is_digit(data[position]); ++position){
+                        has_digit = true;
+                        const auto digit = static_cast<std::uint32_t>(data[position] - '0');
+                        if (n_digits < max_significant_digits){
+                            if (n_digits != 0 || digit != 0){
+                                significand.multiply_add(10, digit);
+                                ++n_digits;
+                            }
+                            if (fractional){
+                                --exponent;
+                            }
+                        }
+                        else{
+                            truncated |= digit != 0;
+                            if (!fractional){
+                                ++exponent;
+                            }
+                        }
+                    }
+                };
+
+                read_digits(false);
+                if (!eof() && data[position] == '.'){
+                    ++position;
+                    read_digits(true);
+                }
+                if (!has_digit){
+                    throw std::invalid_argument { "Expected a floating point number." };
+                }
+
+                if (!eof() && (data[position] == 'e' || data[position] == 'E')){
+                    ++position;
+                    bool negative_exponent = false;
+                    if (!eof() && (data[position] == '-' || data[position] == '+')){
+                        negative_exponent = data[position++] == '-';
+                    }
+                    const int explicit_exponent = static_cast<int>(read_unsigned<std::uint16_t>());
+                    exponent += negative_exponent ? -explicit_exponent : explicit_exponent;
+                }
+
+                if (n_digits == 0){
+                    return negative ? -T { 0 } : T { 0 };
+                }
+                if (truncated){
+                    // Appending a nonzero digit keeps the value on the same side of every rounding boundary.
+                    significand.multiply_add(10, 1);
+                    ++n_digits;
+                    --exponent;
+                }
+
+                // The value is in [10^(decimal_exponent - 1), 10^decimal_exponent). Reject it before scaling if it is
+                // certainly out of range, which also bounds the size of the integers below.
+                const int decimal_exponent = exponent + n_digits;
+                if (decimal_exponent > std::numeric_limits<T>::max_exponent10 + 1 ||
+                    decimal_exponent < std::numeric_limits<T>::min_exponent10 - std::numeric_limits<T>::max_digits10 - 1)
+                {
+                    throw std::invalid_argument { "Floating point number is out of range." };
+                }
+
+                const T result = round_to_floating<T>(std::move(significand), exponent);
+                return negative ? -result : result;
+            }
+
+            template <typename T>
+            [[nodiscard]] constexpr T read_number(){
+                if constexpr (std::floating_point<T>){
+                    return read_floating<T>();
+                }
+                else if constexpr (std::unsigned_integral<T>){
+                    return read_unsigned<T>();
+                }
+                else{
+                    skip_spaces();
+                    const bool negative = !eof() && data[position] == '-';
+                    if (negative){
+                        ++position;
+                    }
+                    const auto magnitude = read_unsigned<std::make_unsigned_t<T>>();
+                    return negative ? static_cast<T>(-static_cast<T>(magnitude)) : static_cast<T>(magnitude);
+                }
+            }
+
+            template <geometry::concepts::vec_type VecT>
+            constexpr void read_vec_into(VecT &result){
+                [&]<std::size_t... Is>(std::index_sequence<Is...>){
+                    ((geometry::nth<Is>(result) = read_number<geometry::vec_value_t<VecT>>()), ...);
+                }(std::make_index_sequence<geometry::vec_size_v<VecT>>{});
+            }
+
+            template <geometry::concepts::vec_type VecT>
+            [[nodiscard]] constexpr VecT read_vec(){
+                VecT result {};
+                read_vec_into(result);
+                return result;
+            }
+
+            template <geometry::concepts::vec_type VecT>
+            [[nodiscard]] constexpr std::optional<VecT> read_vec_within_line(){
+                std::array<geometry::vec_value_t<VecT>, geometry::vec_size_v<VecT>> buffer {};
+                for (auto &elem : buffer){
+                    if (at_line_end()){
+                        return std::nullopt;
+                    }
+
+                    elem = read_number<geometry::vec_value_t<VecT>>();
+                }
+
+                VecT result {};
+                [&]<std::size_t... Is>(std::index_sequence<Is...>){
+                    ((geometry::nth<Is>(result) = buffer[Is]), ...);
+                }(std::make_index_sequence<geometry::vec_size_v<VecT>>{});
+                return result;
+            }
+
+        private:
+            std::string_view data;
+            std::size_t position = 0;
+
+            [[nodiscard]] static constexpr bool is_digit(char c) noexcept{
+                return c >= '0' && c <= '9';
+            }
+
+            constexpr void skip_spaces() noexcept{
+                while (!eof() && (data[position] == ' ' || data[position] == '\t' || data[position] == '\r')){
+                    ++position;
+                }
+            }
+        };
+    }
+
+    /**
+     * @brief Read the element counts of OFF \p data, to be used as the extent of parse_static.
+     * @param data Whole content of an OFF file.
+     * @return Number of vertices and faces, and the maximum number of vertices in a face.
+     */
+    [[nodiscard]] constexpr geometry::static_mesh_extent static_extent_of(std::string_view data){
+        details::static_reader reader { data };
+
+        // Ignore the first line (header).
+        reader.ignore_until_newline();
+        reader.ignore_comment_or_empty_lines();
+
+        geometry::static_mesh_extent extent {};
+        extent.n_vertices = reader.read_unsigned<std::size_t>();
+        extent.n_faces = reader.read_unsigned<std::size_t>();
+        reader.ignore_until_newline();
+
+        for (std::size_t i = 0; i < extent.n_vertices; ++i){
+            reader.ignore_comment_or_empty_lines();
+            reader.ignore_until_newline();
+        }
+
+        for (std::size_t i = 0; i < extent.n_faces; ++i){
+            reader.ignore_comment_or_empty_lines();
+            const auto n_vertices_in_face = reader.read_unsigned<std::size_t>();
+            if (n_vertices_in_face > extent.max_face_size){
+                extent.max_face_size = n_vertices_in_face;
+            }
+            reader.ignore_until_newline();
+        }
+
+        return extent;
+    }
+
+    /**
+     * @brief Parse OFF \p data into a fixed-capacity mesh. Usable in constant evaluation.
+     * @note Numbers are parsed the same as parse, but face colors are not stored: the rest of each face line is skipped.
+     * @tparam VertexT Vertex type, whose color is parsed the same way as parse.
+     * @tparam IndexT Integral type of face vertex indices.
+     * @tparam Extent Element counts of \p data, which must be obtained by static_extent_of(data).
+     * @param data Whole content of an OFF file.
+     * @return Parsed mesh.
+     */
+    template <geometry::concepts::vertex_type VertexT, std::integral IndexT, geometry::static_mesh_extent Extent>
+    [[nodiscard]] constexpr geometry::static_mesh<VertexT, IndexT, Extent> parse_static(std::string_view data){
+        using mesh_type = geometry::static_mesh<VertexT, IndexT, Extent>;
+
+        details::static_reader reader { data };
+
+        // Ignore the first line (header).
+        reader.ignore_until_newline();
+        reader.ignore_comment_or_empty_lines();
+
+        // Read number of vertices, faces, and edges.
+        mesh_type mesh {};
+        if (reader.read_unsigned<std::size_t>() != Extent.n_vertices ||
+            reader.read_unsigned<std::size_t>() != Extent.n_faces)
+        {
+            throw std::invalid_argument { "Extent does not match the data." };
+        }
+        mesh.n_edges = reader.read_unsigned<std::size_t>();
+        reader.ignore_until_newline();
+
+        // Parse vertices.
+        using traits = geometry::vertex_traits<VertexT>;
+        for (auto &vertex : mesh.vertices){
+            reader.ignore_comment_or_empty_lines();
+
+            // Parse position.
+            reader.read_vec_into(traits::position(vertex));
+
+            // Parse color if vertex type contains color field.
+            if constexpr (traits::color == geometry::color_kind::required){
+                traits::set_color(vertex, reader.read_vec<typename traits::color_type>());
+            }
+            else if constexpr (traits::color == geometry::color_kind::optional){
+                traits::set_color(vertex, reader.read_vec_within_line<typename traits::color_type>());
+            }
+
+            reader.ignore_until_newline();
+        }
+
+        // Parse faces.
+        for (auto &face : mesh.faces){
+            reader.ignore_comment_or_empty_lines();
+
+            face.n_vertices = reader.read_unsigned<std::size_t>();
+            if (face.n_vertices > Extent.max_face_size){
+                throw std::invalid_argument { "Extent does not match the data." };
+            }
+
+            for (std::size_t j = 0; j < face.n_vertices; ++j){
+                const auto index = reader.read_unsigned<std::make_unsigned_t<IndexT>>();
+                if (index >= Extent.n_vertices){
+                    throw std::invalid_argument { "Face references a vertex index out of range." };
+                }
+                face.vertex_indices[j] = static_cast<IndexT>(index);
+            }
+
+            reader.ignore_until_newline();
+        }
+
+        return mesh;
+    }
+}
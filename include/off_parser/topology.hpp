@@ -0,0 +1,424 @@
+//
+// Created by gomkyung2 on 10/18/26.
+//
+
+// Topology validation and repair of parsed meshes. Edges are matched by sorting the half-edges of all faces by their
+// undirected vertex pair, in parallel.
+//
+// if (!off_parser::validate_topology(mesh).is_valid()){
+//     off_parser::repair_topology(mesh);
+// }
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <compare>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "geometry/mesh.hpp"
+#include "concepts.hpp"
+#include "details/parallel.hpp"
+
+namespace off_parser{
+    struct topology_report{
+        std::vector<std::size_t> out_of_range_faces;    // Faces referencing a vertex index out of range.
+        std::vector<std::size_t> degenerate_faces;      // Faces with less than 3 vertices or a repeated vertex.
+        std::vector<std::size_t> non_manifold_faces;    // Faces with an edge shared by more than two faces.
+        std::vector<std::size_t> inconsistent_faces;    // Faces with an edge traversed in the same direction by the other face.
+        std::vector<std::size_t> unreferenced_vertices; // Vertices not referenced by any face.
+        std::size_t n_non_manifold_edges = 0;
+        std::size_t n_inconsistent_edges = 0;
+        std::size_t n_boundary_edges = 0;               // Edges of a single face. Not an error.
+
+        // Whether the mesh has no invalid face, non-manifold edge or inconsistent winding.
+        [[nodiscard]] bool is_valid() const noexcept{
+            return out_of_range_faces.empty() && degenerate_faces.empty() && non_manifold_faces.empty() && inconsistent_faces.empty();
+        }
+    };
+
+    struct repair_options{
+        bool drop_invalid_faces = true; // Drop the out of range and degenerate faces.
+        bool unify_orientation = true;  // Flip faces so that every manifold edge is traversed in opposite directions.
+        bool compact_vertices = true;   // Remove the unreferenced vertices.
+    };
+
+    struct repair_result{
+        std::size_t n_dropped_faces = 0;
+        std::size_t n_flipped_faces = 0;
+        std::size_t n_removed_vertices = 0;
+        std::size_t n_orientation_conflicts = 0; // Edges left inconsistent, because their component is not orientable.
+    };
+
+    namespace details{
+        enum class face_state : std::uint8_t { valid, out_of_range, degenerate };
+
+        template <typename IndexT>
+        [[nodiscard]] bool is_index_in_range(IndexT index, std::size_t n_vertices) noexcept{
+            return !std::cmp_less(index, 0) && std::cmp_less(index, n_vertices);
+        }
+
+        template <geometry::concepts::face_type FaceT>
+        [[nodiscard]] face_state classify_face(const FaceT &face, std::size_t n_vertices){
+            const auto &indices = face.vertex_indices;
+            for (auto index : indices){
+                if (!is_index_in_range(index, n_vertices)){
+                    return face_state::out_of_range;
+                }
+            }
+            if (indices.size() < 3){
+                return face_state::degenerate;
+            }
+
+            // Faces are small in practice, so the quadratic check beats sorting a copy.
+            for (std::size_t i = 1; i < indices.size(); ++i){
+                for (std::size_t j = 0; j < i; ++j){
+                    if (indices[i] == indices[j]){
+                        return face_state::degenerate;
+                    }
+                }
+            }
+            return face_state::valid;
+        }
+
+        template <geometry::concepts::mesh_type MeshT>
+        [[nodiscard]] std::vector<face_state> classify_faces(const MeshT &mesh){
+            std::vector<face_state> states(mesh.faces.size());
+            parallel_for(mesh.faces.size(), 16384, [&](std::size_t i){
+                states[i] = classify_face(mesh.faces[i], mesh.vertices.size());
+            });
+            return states;
+        }
+
+        struct half_edge{
+            std::uint64_t key;                // min(a, b) << 32 | max(a, b), for the half-edge a -> b.
+            std::uint64_t face_and_direction; // face << 1 | (a < b).
+
+            [[nodiscard]] std::size_t face() const noexcept{
+                return static_cast<std::size_t>(face_and_direction >> 1);
+            }
+
+            [[nodiscard]] bool forward() const noexcept{
+                return face_and_direction & 1;
+            }
+
+            // Ordered by key, then by face.
+            auto operator<=>(const half_edge&) const noexcept = default;
+        };
+
+        // Half-edges of the valid faces, sorted by undirected edge.
+        template <geometry::concepts::mesh_type MeshT>
+        [[nodiscard]] std::vector<half_edge> sorted_half_edges(const MeshT &mesh, const std::vector<face_state> &states){
+            if (mesh.vertices.size() > std::numeric_limits<std::uint32_t>::max()){
+                throw std::out_of_range { "Too many vertices for edge matching." };
+            }
+
+            std::vector<std::size_t> offsets(mesh.faces.size() + 1, 0);
+            for (std::size_t i = 0; i < mesh.faces.size(); ++i){
+                offsets[i + 1] = offsets[i] + (states[i] == face_state::valid ? mesh.faces[i].vertex_indices.size() : 0);
+            }
+
+            std::vector<half_edge> half_edges(offsets.back());
+            parallel_for(mesh.faces.size(), 16384, [&](std::size_t i){
+                if (states[i] != face_state::valid){
+                    return;
+                }
+
+                const auto &indices = mesh.faces[i].vertex_indices;
+                for (std::size_t j = 0; j < indices.size(); ++j){
+                    const auto a = static_cast<std::uint64_t>(indices[j]);
+                    const auto b = static_cast<std::uint64_t>(indices[(j + 1) % indices.size()]);
+                    half_edges[offsets[i] + j] = { std::min(a, b) << 32 | std::max(a, b), static_cast<std::uint64_t>(i) << 1 | (a < b) };
+                }
+            });
+
+            parallel_sort(half_edges.begin(), half_edges.end());
+            return half_edges;
+        }
+
+        /**
+         * @brief Invoke fn(chunk_index, group_begin, group_end) for every group of half-edges with the same key,
+         * concurrently in chunks.
+         * @return Number of chunks.
+         */
+        template <typename Fn>
+        std::size_t for_each_edge_group(const std::vector<half_edge> &half_edges, Fn &&fn){
+            const std::size_t n = half_edges.size();
+            return parallel_for_chunks(n, 65536, [&](std::size_t chunk, std::size_t begin, std::size_t end){
+                // Process the groups starting in [begin, end).
+                const auto starts_group = [&](std::size_t i){
+                    return i == 0 || half_edges[i].key != half_edges[i - 1].key;
+                };
+                while (begin < end && !starts_group(begin)){
+                    ++begin;
+                }
+                while (begin < end){
+                    std::size_t group_end = begin + 1;
+                    while (group_end < n && half_edges[group_end].key == half_edges[begin].key){
+                        ++group_end;
+                    }
+                    fn(chunk, begin, group_end);
+                    begin = group_end;
+                }
+            });
+        }
+
+        // Sort and deduplicate the per-chunk face lists into one.
+        [[nodiscard]] inline std::vector<std::size_t> merge_face_lists(std::vector<std::vector<std::size_t>> &&lists){
+            std::vector<std::size_t> result;
+            for (auto &list : lists){
+                result.insert(result.end(), list.begin(), list.end());
+            }
+            std::ranges::sort(result);
+            result.erase(std::unique(result.begin(), result.end()), result.end());
+            return result;
+        }
+
+        // Vertices referenced by any face. The in range indices of out of range faces count as well.
+        template <geometry::concepts::mesh_type MeshT>
+        [[nodiscard]] std::vector<std::uint8_t> referenced_vertices(const MeshT &mesh){
+            std::vector<std::uint8_t> referenced(mesh.vertices.size(), 0);
+            parallel_for(mesh.faces.size(), 16384, [&](std::size_t i){
+                for (auto index : mesh.faces[i].vertex_indices){
+                    if (is_index_in_range(index, referenced.size())){
+                        std::atomic_ref { referenced[static_cast<std::size_t>(index)] }.store(1, std::memory_order_relaxed);
+                    }
+                }
+            });
+            return referenced;
+        }
+    }
+
+    /**
+     * @brief Check the topology of \p mesh.
+     */
+    template <geometry::concepts::mesh_type MeshT>
+    [[nodiscard]] topology_report validate_topology(const MeshT &mesh){
+        topology_report report;
+
+        const std::vector<details::face_state> states = details::classify_faces(mesh);
+        for (std::size_t i = 0; i < states.size(); ++i){
+            if (states[i] == details::face_state::out_of_range){
+                report.out_of_range_faces.push_back(i);
+            }
+            else if (states[i] == details::face_state::degenerate){
+                report.degenerate_faces.push_back(i);
+            }
+        }
+
+        // Classify the edges.
+        const std::vector<details::half_edge> half_edges = details::sorted_half_edges(mesh, states);
+        struct chunk_result{
+            std::size_t n_non_manifold_edges = 0, n_inconsistent_edges = 0, n_boundary_edges = 0;
+            std::vector<std::size_t> non_manifold_faces, inconsistent_faces;
+        };
+        std::vector<chunk_result> chunk_results(details::hardware_concurrency());
+        const std::size_t n_chunks = details::for_each_edge_group(half_edges, [&](std::size_t chunk, std::size_t begin, std::size_t end){
+            chunk_result &result = chunk_results[chunk];
+            switch (end - begin){
+                case 1:
+                    ++result.n_boundary_edges;
+                    break;
+                case 2:
+                    if (half_edges[begin].forward() == half_edges[begin + 1].forward()){
+                        ++result.n_inconsistent_edges;
+                        result.inconsistent_faces.push_back(half_edges[begin].face());
+                        result.inconsistent_faces.push_back(half_edges[begin + 1].face());
+                    }
+                    break;
+                default:
+                    ++result.n_non_manifold_edges;
+                    for (std::size_t i = begin; i < end; ++i){
+                        result.non_manifold_faces.push_back(half_edges[i].face());
+                    }
+                    break;
+            }
+        });
+
+        std::vector<std::vector<std::size_t>> non_manifold_lists, inconsistent_lists;
+        for (std::size_t chunk = 0; chunk < n_chunks; ++chunk){
+            chunk_result &result = chunk_results[chunk];
+            report.n_non_manifold_edges += result.n_non_manifold_edges;
+            report.n_inconsistent_edges += result.n_inconsistent_edges;
+            report.n_boundary_edges += result.n_boundary_edges;
+            non_manifold_lists.push_back(std::move(result.non_manifold_faces));
+            inconsistent_lists.push_back(std::move(result.inconsistent_faces));
+        }
+        report.non_manifold_faces = details::merge_face_lists(std::move(non_manifold_lists));
+        report.inconsistent_faces = details::merge_face_lists(std::move(inconsistent_lists));
+
+        const std::vector<std::uint8_t> referenced = details::referenced_vertices(mesh);
+        for (std::size_t i = 0; i < referenced.size(); ++i){
+            if (!referenced[i]){
+                report.unreferenced_vertices.push_back(i);
+            }
+        }
+
+        return report;
+    }
+
+    /**
+     * @brief Repair the topology of \p mesh in place, as selected by \p options.
+     *
+     * Orientation is unified per connected component (through manifold edges), keeping the orientation of the
+     * component's lowest-indexed face. Non-manifold edges are left as they are.
+     */
+    template <geometry::concepts::mesh_type MeshT>
+    repair_result repair_topology(MeshT &mesh, const repair_options &options = {}){
+        repair_result result;
+        std::vector<details::face_state> states = details::classify_faces(mesh);
+
+        if (options.drop_invalid_faces){
+            std::size_t n_kept = 0;
+            for (std::size_t i = 0; i < mesh.faces.size(); ++i){
+                if (states[i] == details::face_state::valid){
+                    if (n_kept != i){
+                        mesh.faces[n_kept] = std::move(mesh.faces[i]);
+                    }
+                    ++n_kept;
+                }
+            }
+
+            if constexpr (concepts::instance_of<typename MeshT::face_type, geometry::dense_optional_colored_face>){
+                if (n_kept != mesh.faces.size()){
+                    decltype(mesh.face_colors) kept_colors;
+                    kept_colors.reserve(mesh.face_colors.compact_colors().size());
+                    for (std::size_t i = 0; i < mesh.faces.size(); ++i){
+                        if (states[i] == details::face_state::valid){
+                            kept_colors.push_back(mesh.face_colors[i]);
+                        }
+                    }
+                    mesh.face_colors = std::move(kept_colors);
+                }
+            }
+
+            result.n_dropped_faces = mesh.faces.size() - n_kept;
+            mesh.faces.resize(n_kept);
+            states.assign(n_kept, details::face_state::valid);
+        }
+
+        if (options.unify_orientation){
+            const std::vector<details::half_edge> half_edges = details::sorted_half_edges(mesh, states);
+
+            // Face adjacency through manifold edges, in CSR layout. Each neighbor records whether the shared edge is
+            // traversed in the same direction by both faces, i.e. whether their orientations disagree.
+            struct neighbor{
+                std::size_t face;
+                bool same_direction;
+            };
+            std::vector<std::size_t> offsets(mesh.faces.size() + 1, 0);
+            const auto for_each_manifold_edge = [&](auto &&fn){
+                for (std::size_t i = 0; i < half_edges.size();){
+                    std::size_t end = i + 1;
+                    while (end < half_edges.size() && half_edges[end].key == half_edges[i].key){
+                        ++end;
+                    }
+                    if (end - i == 2){
+                        fn(half_edges[i], half_edges[i + 1]);
+                    }
+                    i = end;
+                }
+            };
+            for_each_manifold_edge([&](const details::half_edge &a, const details::half_edge &b){
+                ++offsets[a.face() + 1];
+                ++offsets[b.face() + 1];
+            });
+            std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+
+            std::vector<neighbor> neighbors(offsets.back());
+            std::vector<std::size_t> cursors(offsets.begin(), offsets.end() - 1);
+            for_each_manifold_edge([&](const details::half_edge &a, const details::half_edge &b){
+                const bool same_direction = a.forward() == b.forward();
+                neighbors[cursors[a.face()]++] = { b.face(), same_direction };
+                neighbors[cursors[b.face()]++] = { a.face(), same_direction };
+            });
+
+            // Breadth-first propagation of the flips.
+            constexpr std::uint8_t unvisited = 2;
+            std::vector<std::uint8_t> flip(mesh.faces.size(), unvisited);
+            std::vector<std::size_t> queue;
+            for (std::size_t seed = 0; seed < mesh.faces.size(); ++seed){
+                if (flip[seed] != unvisited){
+                    continue;
+                }
+
+                flip[seed] = 0;
+                queue.assign(1, seed);
+                for (std::size_t head = 0; head < queue.size(); ++head){
+                    const std::size_t face = queue[head];
+                    for (std::size_t k = offsets[face]; k < offsets[face + 1]; ++k){
+                        const auto [other, same_direction] = neighbors[k];
+                        const std::uint8_t expected = flip[face] ^ static_cast<std::uint8_t>(same_direction);
+                        if (flip[other] == unvisited){
+                            flip[other] = expected;
+                            queue.push_back(other);
+                        }
+                        else if (flip[other] != expected && face < other){
+                            ++result.n_orientation_conflicts; // Counted once per edge.
+                        }
+                    }
+                }
+            }
+
+            details::parallel_for(mesh.faces.size(), 16384, [&](std::size_t i){
+                if (flip[i] == 1){
+                    std::ranges::reverse(mesh.faces[i].vertex_indices);
+                }
+            });
+            result.n_flipped_faces = static_cast<std::size_t>(std::ranges::count(flip, std::uint8_t { 1 }));
+        }
+
+        if (options.compact_vertices){
+            const std::vector<std::uint8_t> referenced = details::referenced_vertices(mesh);
+
+            constexpr std::size_t removed = std::numeric_limits<std::size_t>::max();
+            std::vector<std::size_t> remap(mesh.vertices.size(), removed);
+            std::size_t n_kept = 0;
+            for (std::size_t i = 0; i < mesh.vertices.size(); ++i){
+                if (referenced[i]){
+                    remap[i] = n_kept;
+                    if (n_kept != i){
+                        mesh.vertices[n_kept] = std::move(mesh.vertices[i]);
+                    }
+                    ++n_kept;
+                }
+            }
+
+            if constexpr (geometry::vertex_color_kind_v<typename MeshT::vertex_type> == geometry::color_kind::dense_optional){
+                if (n_kept != mesh.vertices.size()){
+                    decltype(mesh.vertex_colors) kept_colors;
+                    kept_colors.reserve(mesh.vertex_colors.compact_colors().size());
+                    for (std::size_t i = 0; i < mesh.vertices.size(); ++i){
+                        if (referenced[i]){
+                            kept_colors.push_back(mesh.vertex_colors[i]);
+                        }
+                    }
+                    mesh.vertex_colors = std::move(kept_colors);
+                }
+            }
+
+            result.n_removed_vertices = mesh.vertices.size() - n_kept;
+            mesh.vertices.resize(n_kept);
+
+            if (result.n_removed_vertices != 0){
+                // Out of range indices (kept if !options.drop_invalid_faces) stay out of range, since they are at least
+                // the old vertex count.
+                using index_type = typename MeshT::face_type::index_type;
+                details::parallel_for(mesh.faces.size(), 16384, [&](std::size_t i){
+                    for (auto &index : mesh.faces[i].vertex_indices){
+                        if (details::is_index_in_range(index, remap.size())){
+                            index = static_cast<index_type>(remap[static_cast<std::size_t>(index)]);
+                        }
+                    }
+                });
+            }
+        }
+
+        return result;
+    }
+}